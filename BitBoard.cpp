@@ -0,0 +1,181 @@
+#include "BitBoard.h"
+
+#include "Constraints.h"
+
+// Todas as 81 células; casas e pares vêm das regras em uso (Constraints.h).
+static const Bits81 ALL = Bits81(~0ULL, (1ULL << 17) - 1);
+
+BitBoard::BitBoard() {
+    for (auto& plane : planes) plane = ALL;
+}
+
+bool BitBoard::from_grid(const Grid& grid) {
+    *this = BitBoard();
+    for (int i = 0; i < 81; i++) {
+        if (grid[i] == 0) continue;
+        if (grid[i] > 9 || !planes[grid[i] - 1].test(i)) return false;
+        place(i, grid[i] - 1);
+    }
+    return true;
+}
+
+Grid BitBoard::to_grid() const {
+    Grid grid = {};
+    for (int d = 0; d < 9; d++) {
+        Bits81 cells = planes[d] & solved;
+        while (cells.any()) {
+            int i = cells.first();
+            grid[i] = d + 1;
+            cells = cells.minus(Bits81::cell(i));
+        }
+    }
+    return grid;
+}
+
+bool BitBoard::from_board(Board& board) {
+    return from_grid(board.get_grid());
+}
+
+void BitBoard::to_board(Board& board) const {
+    Grid grid = to_grid();
+    for (int i = 0; i < 81; i++) board.set_tile(grid[i], i / 9, i % 9);
+}
+
+void BitBoard::place(int cell, int digit) {
+    Bits81 bit = Bits81::cell(cell);
+    for (auto& plane : planes) plane = plane.minus(bit);
+    planes[digit] = planes[digit].minus(rules().peer_mask[cell]) | bit;
+    solved |= bit;
+}
+
+// Únicos nus via contagem bit a bit sobre os planos (células que aparecem em
+// exatamente um plano) e únicos ocultos por casa; falso em contradição.
+bool BitBoard::propagate() {
+    while (true) {
+        Bits81 unsolved = ALL.minus(solved);
+        if (!unsolved.any()) return true;
+
+        Bits81 ones, twos;
+        for (auto& plane : planes) {
+            twos |= ones & plane;
+            ones |= plane;
+        }
+        if (unsolved.minus(ones).any()) return false;
+
+        Bits81 naked = ones.minus(twos) & unsolved;
+        if (naked.any()) {
+            while (naked.any()) {
+                int i = naked.first();
+                naked = naked.minus(Bits81::cell(i));
+
+                int d = 0;
+                while (d < 9 && !planes[d].test(i)) d++;
+                if (d == 9) return false;
+                place(i, d);
+            }
+            continue;
+        }
+
+        const ConstraintTable& table = rules();
+        bool progress = false;
+        for (int d = 0; d < 9; d++) {
+            for (int h = 0; h < table.num_houses; h++) {
+                Bits81 spots = planes[d] & table.house_mask[h];
+                if ((spots & solved).any()) continue;
+
+                int n = spots.count();
+                if (n == 0) return false;
+                if (n == 1) {
+                    place(spots.first(), d);
+                    progress = true;
+                }
+            }
+        }
+        if (!progress) return true;
+    }
+}
+
+// Prefere uma célula com exatamente dois candidatos; sem nenhuma, procura a
+// de menor contagem. Só faz sentido com células não resolvidas.
+int BitBoard::branch_cell() const {
+    Bits81 unsolved = ALL.minus(solved);
+
+    Bits81 ones, twos, threes;
+    for (auto& plane : planes) {
+        threes |= twos & plane;
+        twos |= ones & plane;
+        ones |= plane;
+    }
+    Bits81 pairs = twos.minus(threes) & unsolved;
+    if (pairs.any()) return pairs.first();
+
+    int best = 10;
+    int cell = unsolved.first();
+    Bits81 rest = unsolved;
+    while (rest.any()) {
+        int i = rest.first();
+        rest = rest.minus(Bits81::cell(i));
+        int n = 0;
+        for (auto& plane : planes) n += plane.test(i);
+        if (n < best) {
+            best = n;
+            cell = i;
+        }
+    }
+    return cell;
+}
+
+// Células resolvidas em `now` mas não em `before`, com o valor (ou 0).
+static void trace_cells(SolveTrace& trace, uint8_t kind, const BitBoard& now, Bits81 before, bool clear) {
+    Bits81 changed = now.solved.minus(before);
+    while (changed.any()) {
+        int i = changed.first();
+        changed = changed.minus(Bits81::cell(i));
+
+        int d = 0;
+        while (d < 9 && !now.planes[d].test(i)) d++;
+        trace.push(kind, i, clear || d == 9 ? 0 : d + 1);
+    }
+}
+
+void BitBoard::search(int limit, std::atomic<int>& count, Grid* solution, SolveTrace* trace,
+                      const CancelToken* cancel) {
+    if (count.load(std::memory_order_relaxed) >= limit) return;
+    if (cancel && cancel->cancelled()) return;
+
+    Bits81 before = solved;
+    bool ok = propagate();
+    if (trace) trace_cells(*trace, TRACE_PROPAGATE, *this, before, !ok);
+    if (!ok) return;
+
+    if (!ALL.minus(solved).any()) {
+        if (count.fetch_add(1) == 0 && solution != nullptr) *solution = to_grid();
+        return;
+    }
+
+    int cell = branch_cell();
+    for (int d = 0; d < 9; d++) {
+        if (!planes[d].test(cell)) continue;
+
+        BitBoard next = *this;
+        next.place(cell, d);
+        if (trace) trace->push(TRACE_PLACE, cell, d + 1);
+        next.search(limit, count, solution, trace, cancel);
+        if (count.load(std::memory_order_relaxed) >= limit) return;
+        if (cancel && cancel->cancelled()) return;
+        if (trace) trace_cells(*trace, TRACE_BACKTRACK, next, solved, true);
+    }
+}
+
+int BitBoard::count_solutions(int limit, Grid* solution, SolveTrace* trace, const CancelToken* cancel) {
+    BitBoard copy = *this;
+    std::atomic<int> count{0};
+    copy.search(limit, count, solution, trace, cancel);
+    return count;
+}
+
+bool BitBoard::solve() {
+    Grid solution;
+    if (count_solutions(1, &solution) == 0) return false;
+    return from_grid(solution);
+}
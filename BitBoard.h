@@ -0,0 +1,121 @@
+#ifndef SUDOKU_BITBOARD_H
+#define SUDOKU_BITBOARD_H
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "Board.h"
+#include "Cancel.h"
+#include "SolveTrace.h"
+#include "sudoku.h"
+
+// Conjunto de até 128 células (usamos 81), mantido em um registrador de
+// 128 bits quando há SSE2 e em dois inteiros de 64 bits nos demais casos.
+class Bits81 {
+private:
+#if defined(__SSE2__)
+    __m128i v;
+
+    explicit Bits81(__m128i v) : v(v) {}
+#else
+    uint64_t lo, hi;
+#endif
+public:
+
+#if defined(__SSE2__)
+    Bits81() : v(_mm_setzero_si128()) {}
+
+    Bits81(uint64_t lo, uint64_t hi) : v(_mm_set_epi64x(hi, lo)) {}
+
+    uint64_t low() const { return _mm_cvtsi128_si64(v); }
+
+    uint64_t high() const { return _mm_cvtsi128_si64(_mm_unpackhi_epi64(v, v)); }
+
+    Bits81 operator&(Bits81 o) const { return Bits81(_mm_and_si128(v, o.v)); }
+
+    Bits81 operator|(Bits81 o) const { return Bits81(_mm_or_si128(v, o.v)); }
+
+    Bits81 operator^(Bits81 o) const { return Bits81(_mm_xor_si128(v, o.v)); }
+
+    // this & ~o
+    Bits81 minus(Bits81 o) const { return Bits81(_mm_andnot_si128(o.v, v)); }
+#else
+    Bits81() : lo(0), hi(0) {}
+
+    Bits81(uint64_t lo, uint64_t hi) : lo(lo), hi(hi) {}
+
+    uint64_t low() const { return lo; }
+
+    uint64_t high() const { return hi; }
+
+    Bits81 operator&(Bits81 o) const { return Bits81(lo & o.lo, hi & o.hi); }
+
+    Bits81 operator|(Bits81 o) const { return Bits81(lo | o.lo, hi | o.hi); }
+
+    Bits81 operator^(Bits81 o) const { return Bits81(lo ^ o.lo, hi ^ o.hi); }
+
+    Bits81 minus(Bits81 o) const { return Bits81(lo & ~o.lo, hi & ~o.hi); }
+#endif
+
+    Bits81& operator&=(Bits81 o) { return *this = *this & o; }
+
+    Bits81& operator|=(Bits81 o) { return *this = *this | o; }
+
+    static Bits81 cell(int i) { return i < 64 ? Bits81(1ULL << i, 0) : Bits81(0, 1ULL << (i - 64)); }
+
+    bool any() const { return (low() | high()) != 0; }
+
+    int count() const { return __builtin_popcountll(low()) + __builtin_popcountll(high()); }
+
+    // Índice do menor bit; o conjunto não pode ser vazio.
+    int first() const { return low() ? __builtin_ctzll(low()) : 64 + __builtin_ctzll(high()); }
+
+    bool test(int i) const { return (*this & cell(i)).any(); }
+};
+
+// Estado de busca em planos de dígitos: o bit i de planes[d] diz que o dígito
+// d + 1 ainda é possível na célula i; `solved` marca as células resolvidas,
+// cujo único plano com o bit ligado é o do valor. A cópia inteira tem 160
+// bytes, então um snapshot é só uma atribuição.
+class BitBoard {
+public:
+    Bits81 planes[9];
+    Bits81 solved;
+
+    BitBoard();
+
+    bool from_grid(const Grid& grid);
+
+    Grid to_grid() const;
+
+    bool from_board(Board& board);
+
+    void to_board(Board& board) const;
+
+    void place(int cell, int digit);
+
+    // Proíbe o dígito na célula (ainda não resolvida).
+    void exclude(int cell, int digit) { planes[digit] = planes[digit].minus(Bits81::cell(cell)); }
+
+    bool propagate();
+
+    int branch_cell() const;
+
+    // Busca que soma ao contador compartilhado e para assim que ele chega a
+    // `limit`, inclusive quando outras threads é que o fizeram chegar lá, ou
+    // quando `cancel` é acionado (a contagem fica incompleta).
+    // Com `trace`, cada passo vira um evento para quem estiver assistindo.
+    void search(int limit, std::atomic<int>& count, Grid* solution, SolveTrace* trace = nullptr,
+                const CancelToken* cancel = nullptr);
+
+    int count_solutions(int limit, Grid* solution = nullptr, SolveTrace* trace = nullptr,
+                        const CancelToken* cancel = nullptr);
+
+    bool solve();
+};
+
+#endif //SUDOKU_BITBOARD_H
@@ -1,14 +1,204 @@
 #include "Board.h"
 
-std::string Board::get_save_path() {
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "BitBoard.h"
+#include "Constraints.h"
+#include "ParallelSearch.h"
+#include "Unavoidable.h"
+
+// Busca dos tamanhos sem bitboard: candidatos de cada célula em máscaras,
+// com únicos nus e ocultos propagados pelas casas de GEOMETRY<N>. A cópia
+// inteira é o snapshot de cada ramificação.
+template<int N>
+struct MaskSearch {
+    static constexpr int SIDE = N * N;
+    static constexpr int CELLS = SIDE * SIDE;
+    typedef typename SizedCandidates<N>::Mask Mask;
+    static constexpr Mask ALL = (Mask) ((1ULL << SIDE) - 1);
+
+    Mask cand[CELLS];
+    uint8_t cells[CELLS];
+    int empty = CELLS;
+
+    MaskSearch() {
+        std::fill(cand, cand + CELLS, ALL);
+        std::fill(cells, cells + CELLS, 0);
+    }
+
+    bool from_grid(const std::array<uint8_t, CELLS>& grid) {
+        for (int i = 0; i < CELLS; i++) {
+            if (grid[i] == 0) continue;
+            if (grid[i] > SIDE || !(cand[i] & ((Mask) 1 << (grid[i] - 1)))) return false;
+            if (!place(i, grid[i] - 1)) return false;
+        }
+        return true;
+    }
+
+    // Falso se algum par vazio fica sem candidatos.
+    bool place(int cell, int digit) {
+        Mask bit = (Mask) 1 << digit;
+        cells[cell] = digit + 1;
+        cand[cell] = 0;
+        empty--;
+
+        for (int p : GEOMETRY<N>.peers[cell]) {
+            if (cells[p] != 0) continue;
+            cand[p] &= ~bit;
+            if (cand[p] == 0) return false;
+        }
+        return true;
+    }
+
+    void exclude(int cell, int digit) { cand[cell] &= ~((Mask) 1 << digit); }
+
+    bool propagate() {
+        while (empty > 0) {
+            bool progress = false;
+            for (int i = 0; i < CELLS; i++) {
+                if (cells[i] != 0) continue;
+                if (cand[i] == 0) return false;
+                if ((cand[i] & (cand[i] - 1)) == 0) {
+                    if (!place(i, __builtin_ctzll(cand[i]))) return false;
+                    progress = true;
+                }
+            }
+            if (progress) continue;
+
+            // Dígito que só cabe numa célula da casa; faltando algum, contradição.
+            for (auto& unit : GEOMETRY<N>.units) {
+                Mask once = 0, twice = 0, placed = 0;
+                for (int i : unit) {
+                    if (cells[i] != 0) {
+                        placed |= (Mask) 1 << (cells[i] - 1);
+                        continue;
+                    }
+                    twice |= once & cand[i];
+                    once |= cand[i];
+                }
+                if ((once | placed) != ALL) return false;
+
+                for (Mask hidden = once & ~twice & ~placed; hidden != 0; hidden &= hidden - 1) {
+                    int d = __builtin_ctzll(hidden);
+                    int cell = -1;
+                    for (int i : unit)
+                        if (cells[i] == 0 && (cand[i] & ((Mask) 1 << d))) cell = i;
+                    if (cell == -1 || !place(cell, d)) return false;
+                    progress = true;
+                }
+            }
+            if (!progress) return true;
+        }
+        return true;
+    }
+
+    // Célula vazia com menos candidatos; dois já é o mínimo depois de propagar.
+    int branch_cell() const {
+        int best = SIDE + 1, cell = -1;
+        for (int i = 0; i < CELLS && best > 2; i++) {
+            if (cells[i] != 0) continue;
+            int n = __builtin_popcountll(cand[i]);
+            if (n < best) {
+                best = n;
+                cell = i;
+            }
+        }
+        return cell;
+    }
+};
+
+// `nodes` negativo ao voltar: a contagem parou no limite de nós.
+template<int N>
+static void count_masks(MaskSearch<N> search, int limit, int& count, long& nodes, const CancelToken* cancel,
+                        SearchStats* stats) {
+    if (cancel && cancel->cancelled()) return;
+    if (--nodes < 0) return;
+    if (stats) stats->nodes++;
+
+    if (!search.propagate()) {
+        if (stats) stats->backtracks++;
+        return;
+    }
+    if (search.empty == 0) {
+        count++;
+        return;
+    }
+
+    int cell = search.branch_cell();
+    for (int d = 0; d < MaskSearch<N>::SIDE; d++) {
+        if (!(search.cand[cell] & ((typename MaskSearch<N>::Mask) 1 << d))) continue;
+
+        MaskSearch<N> next = search;
+        if (next.place(cell, d)) count_masks(next, limit, count, nodes, cancel, stats);
+        if (count >= limit || nodes < 0) return;
+    }
+}
+
+// Soluções (até 2) de um tabuleiro fora do 9x9 em até `nodes` nós; a
+// contagem que estoura o limite vale 0, pois não prova nada.
+template<int N>
+static int count_sized(const std::array<uint8_t, N * N * N * N>& grid, long& nodes, const CancelToken* cancel,
+                       SearchStats* stats) {
+    MaskSearch<N> search;
+    if (!search.from_grid(grid)) return 0;
+
+    int count = 0;
+    count_masks(search, 2, count, nodes, cancel, stats);
+    return nodes < 0 ? 0 : count;
+}
+
+// Como fill_bits, sobre máscaras.
+template<int N>
+static bool fill_masks(MaskSearch<N>& search, bool random, long& nodes, Clock::time_point deadline,
+                       const CancelToken* cancel) {
+    if (--nodes < 0) return false;
+    if ((nodes & 0xFF) == 0 && (Clock::now() >= deadline || (cancel && cancel->cancelled()))) {
+        nodes = -1;
+        return false;
+    }
+
+    if (!search.propagate()) return false;
+    if (search.empty == 0) return true;
+
+    int cell = search.branch_cell();
+    int order[MaskSearch<N>::SIDE];
+    for (int k = 0; k < MaskSearch<N>::SIDE; k++) order[k] = k;
+    if (random) {
+        for (int k = MaskSearch<N>::SIDE - 1; k > 0; k--)
+            std::swap(order[k], order[rand() % (k + 1)]);
+    }
+
+    for (int d : order) {
+        if (!(search.cand[cell] & ((typename MaskSearch<N>::Mask) 1 << d))) continue;
+
+        MaskSearch<N> next = search;
+        if (!next.place(cell, d)) continue;
+        if (fill_masks(next, random, nodes, deadline, cancel)) {
+            search = next;
+            return true;
+        }
+        if (nodes < 0) return false;
+    }
+
+    return false;
+}
+
+template<int N>
+std::string BasicBoard<N>::get_save_path() {
     char* path = SDL_GetPrefPath(COMP_NAME, GAME_NAME);
     std::string complete_path {path};
 
     complete_path = complete_path + "save_game";
+    if (N != 3) complete_path += "_" + std::to_string(SIDE);
     return complete_path;
 }
 
-bool Board::save(Options &opts) {
+// Uma linha por célula: o valor, somado a SIDE + 1 quando não é pista (10 no
+// 9x9).
+template<int N>
+bool BasicBoard<N>::save(Options &opts) {
     std::string complete_path = get_save_path();
 
     std::ofstream fptr;
@@ -16,21 +206,23 @@ bool Board::save(Options &opts) {
 
     if (!fptr.is_open()) return false;
 
-    for (int l = 0; l < 9; l++) {
-        for (int c = 0; c < 9; c++) {
+    for (int l = 0; l < SIDE; l++) {
+        for (int c = 0; c < SIDE; c++) {
             int val = tiles[l][c];
-            if (!original[l][c]) val += 10;
+            if (!original[l * SIDE + c]) val += SIDE + 1;
             fptr << val << std::endl;
         }
     }
     fptr << opts.num_remove << std::endl;
+    fptr << opts.variant << std::endl;
 
     fptr.close();
 
     return true;
 }
 
-void Board::load(Options &opts) {
+template<int N>
+void BasicBoard<N>::load(Options &opts) {
     std::string complete_path = get_save_path();
     std::string buffer;
     std::ifstream fptr(complete_path);
@@ -38,18 +230,18 @@ void Board::load(Options &opts) {
     if (!fptr.is_open()) return;
 
     int l = 0, c = 0;
-    while (l < 9) {
+    while (l < SIDE) {
         getline (fptr, buffer);
         int value = std::stoi(buffer);
 
-        tiles[l][c] = value % 10;
-        original[l][c] = value < 10;
+        tiles[l][c] = value % (SIDE + 1);
+        original[l * SIDE + c] = value <= SIDE;
 
         c++;
-        if (c == 9) c = 0, l++;
+        if (c == SIDE) c = 0, l++;
     }
 
-    if (l != 9) {
+    if (l != SIDE) {
         fptr.close();
         return;
     }
@@ -57,109 +249,321 @@ void Board::load(Options &opts) {
     getline (fptr, buffer);
     opts.num_remove = std::stoi(buffer);
 
+    // Jogos salvos antes das variantes são clássicos; fora do 9x9 só há o clássico.
+    opts.variant = VARIANT_CLASSIC;
+    if (getline (fptr, buffer)) opts.variant = std::stoi(buffer);
+    if (N != 3 || opts.variant < 0 || opts.variant >= NUM_VARIANTS) opts.variant = VARIANT_CLASSIC;
+    if constexpr (N == 3) set_variant(opts.variant);
+
     fptr.close();
 }
 
-bool Board::is_original(int l, int c) {
-    return original[l][c];
+template<int N>
+typename BasicBoard<N>::Snapshot BasicBoard<N>::snapshot() {
+    Snapshot snap;
+    std::memcpy(snap.tiles, tiles, sizeof(tiles));
+    snap.original = original;
+    return snap;
 }
 
-int Board::get_tile(int l, int c) {
+template<int N>
+void BasicBoard<N>::restore(const Snapshot& snap) {
+    std::memcpy(tiles, snap.tiles, sizeof(tiles));
+    original = snap.original;
+}
+
+template<int N>
+bool BasicBoard<N>::is_original(int l, int c) {
+    return original[l * SIDE + c];
+}
+
+template<int N>
+int BasicBoard<N>::get_tile(int l, int c) {
     return tiles[l][c];
 }
 
-void Board::set_tile(int val, int l, int c) {
+template<int N>
+void BasicBoard<N>::set_tile(int val, int l, int c) {
     tiles[l][c] = val;
 }
 
-void Board::clear() {
-    for (int l = 0; l < 9; l++) {
-        for (int c = 0; c < 9; c++) {
-            tiles[l][c] = 0;
-            original[l][c] = false;
-        }
-    }
+template<int N>
+typename BasicBoard<N>::Cells BasicBoard<N>::get_grid() {
+    Cells grid;
+    std::memcpy(grid.data(), tiles, sizeof(tiles));
+    return grid;
+}
+
+template<int N>
+void BasicBoard<N>::set_grid(const Cells& grid) {
+    std::memcpy(tiles, grid.data(), sizeof(tiles));
+    for (int i = 0; i < CELLS; i++) original[i] = grid[i] != 0;
 }
 
-void Board::consolidate() {
-    for (int l = 0; l < 9; l++) {
-        for (int c = 0; c < 9; c++) {
+template<int N>
+void BasicBoard<N>::clear() {
+    std::memset(tiles, 0, sizeof(tiles));
+    original.reset();
+}
+
+template<int N>
+void BasicBoard<N>::consolidate() {
+    for (int l = 0; l < SIDE; l++) {
+        for (int c = 0; c < SIDE; c++) {
             if (tiles[l][c] != 0) {
-                original[l][c] = true;
+                original[l * SIDE + c] = true;
             }
         }
     }
 }
 
-void Board::clear_user() {
-    for (int l = 0; l < 9; l++)
-        for (int c = 0; c < 9; c++)
+template<int N>
+void BasicBoard<N>::clear_user() {
+    for (int l = 0; l < SIDE; l++)
+        for (int c = 0; c < SIDE; c++)
             if (!is_original(l, c))
                 tiles[l][c] = 0;
 }
 
-bool Board::remove(int num_remove) {
+// Progresso em células removidas; cancelar ou estourar o prazo interrompe a
+// remoção e devolve false.
+template<int N>
+bool BasicBoard<N>::remove(int num_remove, Clock::time_point deadline, const CancelToken* cancel, const Progress& progress) {
     int tries = 0;
+    int total = num_remove;
+    effort = SearchStats();
+
+    // Para jogos esparsos, uma remoção que esvazia um conjunto inevitável da
+    // solução é recusada sem busca (só no 9x9).
+    Unavoidable ua;
+    Bits81 clues;
+    bool use_ua = false;
+    if constexpr (N == 3) {
+        use_ua = num_remove >= UA_MIN_BLANKS && next_empty().first == -1;
+        if (use_ua) {
+            ua.build(get_grid());
+            for (int i = 0; i < 81; i++) clues |= Bits81::cell(i);
+        }
+    }
+
+    // Fora do 9x9, uma pista recusada fica marcada e não é sorteada de novo:
+    // tirar outras só acrescenta soluções e alonga as provas, então ela nunca
+    // mais sai. As provas têm orçamento proporcional à mais longa já aceita.
+    std::bitset<CELLS> kept;
+    int left = 0;
+    long hardest = 0;
+    if constexpr (N != 3) {
+        for (int i = 0; i < CELLS; i++) left += tiles[i / SIDE][i % SIDE] != 0;
+    }
 
     while (num_remove > 0 && tries < MAX_TRIES) {
-        int l = rand() % 9;
-        int c = rand() % 9;
+        if (Clock::now() >= deadline || (cancel && cancel->cancelled())) break;
+        if (N != 3 && (int) kept.count() == left) break;
+
+        int l = rand() % SIDE;
+        int c = rand() % SIDE;
 
-        if (tiles[l][c] == 0) continue;
+        if (tiles[l][c] == 0 || kept[l * SIDE + c]) continue;
+
+        if (use_ua && ua.misses(clues.minus(Bits81::cell(l * SIDE + c)))) {
+            tries++;
+            continue;
+        }
 
         int backup = tiles[l][c];
         tiles[l][c] = 0;
 
-        if (is_unique_solvable()) {
+        // A última remoção aceita é a que buscou sobre o jogo pronto.
+        SearchStats stats;
+        bool unique;
+        if constexpr (N == 3) {
+            unique = is_unique_solvable(cancel, &stats);
+        } else {
+            long nodes = std::clamp(SIZED_PROOF_SCALE * hardest, (long) SIZED_MIN_NODES, (long) SIZED_UNIQUE_NODES);
+            unique = count_sized<N>(get_grid(), nodes, cancel, &stats) == 1 && !(cancel && cancel->cancelled());
+        }
+
+        if (unique) {
+            effort = stats;
+            hardest = std::max(hardest, stats.nodes);
+            if (use_ua) clues = clues.minus(Bits81::cell(l * SIDE + c));
+            left--;
             num_remove--;
+            if (progress) progress(total - num_remove, total);
         } else {
             tiles[l][c] = backup;
+            if (N != 3) kept[l * SIDE + c] = true;
             tries++;
         }
     }
 
-    for (int l = 0; l < 9; l++)
-        for (int c = 0; c < 9; c++)
-            this->original[l][c] = tiles[l][c] != 0;
+    for (int l = 0; l < SIDE; l++)
+        for (int c = 0; c < SIDE; c++)
+            this->original[l * SIDE + c] = tiles[l][c] != 0;
 
-    return tries < MAX_TRIES;
+    return num_remove == 0;
 }
 
-bool Board::fill(bool random) {
-    Coords xy = next_empty();
-    if (xy.first == -1) return true;
+// Fora do 9x9, a recursão por candidatos sem propagação não termina em tempo
+// útil; vai direto para a busca por máscaras, sem limite de nós.
+template<int N>
+bool BasicBoard<N>::fill(bool random) {
+    if constexpr (N != 3) {
+        long nodes = LONG_MAX;
+        return fill_rec(random, nodes, Clock::time_point::max(), nullptr);
+    }
+
+    CandidateSet cand;
+    candidates(cand);
+    if (cand.best == -1) return true;
+
+    int l = cand.best / SIDE;
+    int c = cand.best % SIDE;
 
     int offset = 0;
-    if (random) offset = rand() % 9;
+    if (random) offset = rand() % SIDE;
 
-    for (int val = 0; val < 9; val++) {
-        int maybe = 1 + ((val + offset) % 9);
+    for (int val = 0; val < SIDE; val++) {
+        int maybe = 1 + ((val + offset) % SIDE);
 
-        if (!is_allowed(maybe, xy.first, xy.second)) continue;
+        if (!(cand.mask[cand.best] & (1 << (maybe - 1)))) continue;
 
-        tiles[xy.first][xy.second] = maybe;
-        if (!fill(random)) tiles[xy.first][xy.second] = 0;
+        tiles[l][c] = maybe;
+        if (!fill(random)) tiles[l][c] = 0;
         else return true;
     }
 
     return false;
 }
 
-bool Board::unique_rec(int &numSols) {
-    Coords xy = next_empty();
-    if (xy.first == -1) {
+// Busca em bitboard com uma permutação aleatória nova dos dígitos em cada
+// ramificação; a propagação (com únicos ocultos) é o que segura regiões
+// irregulares, onde só os candidatos da célula deixam a busca se perder.
+static bool fill_bits(BitBoard& board, bool random, long& nodes, Clock::time_point deadline,
+                      const CancelToken* cancel) {
+    if (--nodes < 0) return false;
+    if ((nodes & 0xFF) == 0 && (Clock::now() >= deadline || (cancel && cancel->cancelled()))) {
+        nodes = -1;
+        return false;
+    }
+
+    if (!board.propagate()) return false;
+    if (board.solved.count() == 81) return true;
+
+    int cell = board.branch_cell();
+    int order[9] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    if (random) {
+        for (int k = 8; k > 0; k--)
+            std::swap(order[k], order[rand() % (k + 1)]);
+    }
+
+    for (int d : order) {
+        if (!board.planes[d].test(cell)) continue;
+
+        BitBoard next = board;
+        next.place(cell, d);
+        if (fill_bits(next, random, nodes, deadline, cancel)) {
+            board = next;
+            return true;
+        }
+        if (nodes < 0) return false;
+    }
+
+    return false;
+}
+
+// Como fill(), mas com um limite de nós; `nodes` negativo ao voltar indica
+// que o limite (ou o prazo) acabou, e não que o tabuleiro não tem solução.
+template<int N>
+bool BasicBoard<N>::fill_rec(bool random, long& nodes, Clock::time_point deadline, const CancelToken* cancel) {
+    if constexpr (N == 3) {
+        BitBoard board;
+        if (!board.from_grid(get_grid())) return false;
+        if (!fill_bits(board, random, nodes, deadline, cancel)) return false;
+
+        board.to_board(*this);
+    } else {
+        MaskSearch<N> search;
+        if (!search.from_grid(get_grid())) return false;
+        if (!fill_masks(search, random, nodes, deadline, cancel)) return false;
+
+        for (int i = 0; i < CELLS; i++) tiles[i / SIDE][i % SIDE] = search.cells[i];
+    }
+    return true;
+}
+
+long luby(long i) {
+    for (int k = 1;; k++) {
+        if (i == (1L << k) - 1) return 1L << (k - 1);
+        if (i < (1L << k) - 1) return luby(i - (1L << (k - 1)) + 1);
+    }
+}
+
+// Preenchimento com orçamento: reinícios com novas ordens aleatórias, cada
+// um limitado a RESTART_NODES * luby(i) nós, até esgotar `max_nodes` ou o prazo.
+template<int N>
+bool BasicBoard<N>::fill(bool random, long max_nodes, Clock::time_point deadline, const CancelToken* cancel) {
+    Snapshot start = snapshot();
+
+    for (long run = 1; max_nodes > 0 && Clock::now() < deadline && !(cancel && cancel->cancelled()); run++) {
+        long nodes = random ? std::min(max_nodes, RESTART_NODES * luby(run)) : max_nodes;
+        max_nodes -= nodes;
+
+        if (fill_rec(random, nodes, deadline, cancel)) return true;
+        restore(start);
+
+        // Busca completa sem solução: reiniciar não adianta.
+        if (nodes >= 0) return false;
+    }
+
+    return false;
+}
+
+// Gera um novo jogo sem passar do prazo nem ignorar um cancelamento; se não
+// conseguir, devolve false e deixa o tabuleiro como estava.
+template<int N>
+bool BasicBoard<N>::generate(int num_remove, Clock::time_point deadline, const CancelToken* cancel, const Progress& progress) {
+    Snapshot start = snapshot();
+
+    while (Clock::now() < deadline && !(cancel && cancel->cancelled())) {
+        if (progress) progress(0, num_remove);
+        clear();
+        if (!fill(true, GENERATE_NODES, deadline, cancel)) continue;
+        if (remove(num_remove, deadline, cancel, progress)) return true;
+    }
+
+    restore(start);
+    return false;
+}
+
+template<int N>
+bool BasicBoard<N>::unique_rec(int &numSols, const CancelToken* cancel, SearchStats* stats, Cells* first) {
+    if (cancel && cancel->cancelled()) return false;
+
+    CandidateSet cand;
+    candidates(cand);
+    if (cand.best == -1) {
+        if (numSols == 0 && first) *first = get_grid();
         numSols++;
         return true;
     }
 
-    for (int val = 1; val <= 9; val++) {
-        if (!is_allowed(val, xy.first, xy.second)) continue;
+    if (stats) {
+        stats->nodes++;
+        if (cand.count[cand.best] == 0) stats->backtracks++;
+    }
+
+    int l = cand.best / SIDE;
+    int c = cand.best % SIDE;
+
+    for (int val = 1; val <= SIDE; val++) {
+        if (!(cand.mask[cand.best] & (1 << (val - 1)))) continue;
 
-        tiles[xy.first][xy.second] = val;
-        if (!unique_rec(numSols)) {
-            tiles[xy.first][xy.second] = 0;
+        tiles[l][c] = val;
+        if (!unique_rec(numSols, cancel, stats, first)) {
+            tiles[l][c] = 0;
         } else {
-            if (numSols < 2) tiles[xy.first][xy.second] = 0;
+            if (numSols < 2) tiles[l][c] = 0;
             else return true;
         }
     }
@@ -167,59 +571,192 @@ bool Board::unique_rec(int &numSols) {
     return false;
 }
 
-bool Board::is_unique_solvable() {
-    int backup[9][9];
-    std::copy(&tiles[0][0], &tiles[0][0] + 81, &backup[0][0]);
-
+// Uma busca cancelada não prova nada, então a resposta é false. Fora do 9x9
+// a contagem é feita com propagação e com até SIZED_UNIQUE_NODES nós: perto
+// do limite de pistas as provas dos tabuleiros grandes explodem, e a remoção
+// que pediu a prova simplesmente fica de fora.
+template<int N>
+bool BasicBoard<N>::is_unique_solvable(const CancelToken* cancel, SearchStats* stats) {
     int sols = 0;
-    unique_rec(sols);
+    if constexpr (N == 3) {
+        Snapshot backup = snapshot();
+        unique_rec(sols, cancel, stats);
+        restore(backup);
+    } else {
+        long nodes = SIZED_UNIQUE_NODES;
+        sols = count_sized<N>(get_grid(), nodes, cancel, stats);
+    }
 
-    std::copy(&backup[0][0], &backup[0][0] + 81, &tiles[0][0]);
+    return sols == 1 && !(cancel && cancel->cancelled());
+}
 
-    return sols == 1;
+// Uma pista é necessária se, sem ela, o tabuleiro tem alguma solução com outro
+// valor na célula: uma única busca com o valor proibido, em vez de contar
+// soluções de novo. Fora do 9x9 a busca tem até SIZED_UNIQUE_NODES nós; uma busca
+// que estoura ou é cancelada não prova nada, e a pista fica.
+template<int N>
+static bool clue_needed(std::array<uint8_t, N * N * N * N> grid, int cell, const CancelToken* cancel = nullptr) {
+    int val = grid[cell];
+    grid[cell] = 0;
+
+    int count = 0;
+    if constexpr (N == 3) {
+        BitBoard board;
+        if (!board.from_grid(grid)) return true;
+        board.exclude(cell, val - 1);
+        count = board.count_solutions(1, nullptr, nullptr, cancel);
+    } else {
+        MaskSearch<N> search;
+        if (!search.from_grid(grid)) return true;
+        search.exclude(cell, val - 1);
+
+        long nodes = SIZED_UNIQUE_NODES;
+        count_masks(search, 1, count, nodes, cancel, nullptr);
+        if (nodes < 0) return true;
+    }
+    return count > 0 || (cancel && cancel->cancelled());
 }
 
-bool Board::lin_has_val(int val, int lin) {
-    for (int k = 0; k < 9; k++)
-        if (tiles[lin][k] == val)
-            return true;
-    return false;
+// Retira pistas redundantes, em ordem aleatória, até nenhuma poder sair sem
+// perder a unicidade. Uma passada basta: tirar pistas só acrescenta soluções,
+// então uma pista necessária continua necessária. Espera um jogo de solução
+// única; devolve false se for cancelado no meio.
+template<int N>
+bool BasicBoard<N>::make_minimal(const CancelToken* cancel) {
+    Cells grid = get_grid();
+    for (int i = 0; i < CELLS; i++) if (!original[i]) grid[i] = 0;
+
+    int order[CELLS];
+    for (int i = 0; i < CELLS; i++) order[i] = i;
+    for (int k = CELLS - 1; k > 0; k--) std::swap(order[k], order[rand() % (k + 1)]);
+
+    for (int i : order) {
+        if (cancel && cancel->cancelled()) return false;
+        if (grid[i] == 0 || clue_needed<N>(grid, i, cancel)) continue;
+
+        grid[i] = 0;
+        tiles[i / SIDE][i % SIDE] = 0;
+        original[i] = false;
+    }
+    if (cancel && cancel->cancelled()) return false;
+
+    effort = SearchStats();
+    is_unique_solvable(nullptr, &effort);
+    return true;
 }
 
-bool Board::col_has_val(int val, int col) {
-    for (int k = 0; k < 9; k++)
-        if (tiles[k][col] == val)
-            return true;
-    return false;
+template<int N>
+bool BasicBoard<N>::is_minimal() {
+    Cells grid = get_grid();
+    for (int i = 0; i < CELLS; i++) if (!original[i]) grid[i] = 0;
+    for (int i = 0; i < CELLS; i++)
+        if (grid[i] != 0 && !clue_needed<N>(grid, i)) return false;
+    return true;
 }
 
-bool Board::block_has_val(int val, int lin, int col) {
-    lin = (lin / 3) * 3;
-    col = (col / 3) * 3;
+// Mesma pergunta, mas com a busca em bitboard dividida entre os núcleos; os
+// outros tamanhos não têm bitboard e buscam numa thread só.
+template<int N>
+bool BasicBoard<N>::is_unique_solvable(ThreadPool& pool) {
+    if constexpr (N == 3) {
+        BitBoard board;
+        if (!board.from_grid(get_grid())) return false;
+        return count_solutions_parallel(board, 2, pool) == 1;
+    } else {
+        return is_unique_solvable();
+    }
+}
 
-    for (int l = lin; l < lin + 3; l++)
-        for (int c = col; c < col + 3; c++)
-            if (tiles[l][c] == val)
-                return true;
-    return false;
+template<int N>
+bool BasicBoard<N>::is_valid() {
+    for (int l = 0; l < SIDE; l++) {
+        for (int c = 0; c < SIDE; c++) {
+            int val = tiles[l][c];
+            if (val == 0) continue;
+            if (val < 0 || val > SIDE) return false;
+
+            tiles[l][c] = 0;
+            bool allowed = is_allowed(val, l, c);
+            tiles[l][c] = val;
+            if (!allowed) return false;
+        }
+    }
+    return true;
 }
 
-bool Board::is_allowed(int val, int lin, int col) {
+// No 9x9, os pares da célula vêm das regras em uso, então diagonais, janelas
+// e regiões do jigsaw são checadas do mesmo jeito que linhas e colunas.
+template<int N>
+bool BasicBoard<N>::is_allowed(int val, int lin, int col) {
     if (tiles[lin][col] != 0)
         return false;
-    if (lin_has_val(val, lin))
-        return false;
-    if (col_has_val(val, col))
-        return false;
-    if (block_has_val(val, lin, col))
-        return false;
+
+    const uint8_t* cells = &tiles[0][0];
+    int i = lin * SIDE + col;
+    if constexpr (N == 3) {
+        const ConstraintTable& table = rules();
+        for (int k = 0; k < table.num_peers[i]; k++)
+            if (cells[table.peers[i][k]] == val)
+                return false;
+    } else {
+        for (int p : GEOMETRY<N>.peers[i])
+            if (cells[p] == val)
+                return false;
+    }
     return true;
 }
 
-Coords Board::next_empty() {
-    for (int l = 0; l < 9; l++)
-        for (int c = 0; c < 9; c++)
+// Candidatos de todas as células em uma passada; a busca ramifica na célula
+// com menos candidatos em vez de na primeira vazia. No 9x9, o kernel cobre
+// linhas, colunas e caixas comuns; as outras casas da variante vêm depois.
+template<int N>
+void BasicBoard<N>::candidates(CandidateSet& out) {
+    const uint8_t* cells = &tiles[0][0];
+
+    if constexpr (N == 3) {
+        const ConstraintTable& table = rules();
+
+        uint16_t rows[9], cols[9], boxes[9];
+        house_masks(cells, rows, cols, boxes);
+        if (table.kernel_houses < 27) std::fill(boxes, boxes + 9, 0);
+        compute_candidates(cells, rows, cols, boxes, out);
+        if (table.kernel_houses < table.num_houses) table.restrict(cells, out);
+    } else {
+        typedef typename SizedCandidates<N>::Mask Mask;
+
+        Mask used[3 * SIDE] = {};
+        for (int u = 0; u < 3 * SIDE; u++)
+            for (int i : GEOMETRY<N>.units[u])
+                if (cells[i] != 0) used[u] |= (Mask) 1 << (cells[i] - 1);
+
+        const Mask all = (Mask) ((1ULL << SIDE) - 1);
+        int best_count = SIDE + 1;
+        out.best = -1;
+        for (int i = 0; i < CELLS; i++) {
+            int l = i / SIDE, c = i % SIDE;
+            out.mask[i] = 0;
+            if (cells[i] == 0)
+                out.mask[i] = all & ~(used[l] | used[SIDE + c] | used[2 * SIDE + (l / N) * N + c / N]);
+            out.count[i] = __builtin_popcountll(out.mask[i]);
+
+            if (cells[i] == 0 && out.count[i] < best_count) {
+                best_count = out.count[i];
+                out.best = i;
+            }
+        }
+    }
+}
+
+template<int N>
+Coords BasicBoard<N>::next_empty() {
+    for (int l = 0; l < SIDE; l++)
+        for (int c = 0; c < SIDE; c++)
             if (tiles[l][c] == 0)
                 return std::make_pair(l, c);
     return std::make_pair(-1, -1);
 }
+
+template class BasicBoard<2>;
+template class BasicBoard<3>;
+template class BasicBoard<4>;
+template class BasicBoard<5>;
@@ -1,26 +1,135 @@
 #ifndef SUDOKU_BOARD_H
 #define SUDOKU_BOARD_H
 
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <fstream>
+#include <type_traits>
 
 #include <SDL2/SDL.h>
 
+#include "Cancel.h"
+#include "Candidates.h"
+#include "ThreadPool.h"
 #include "sudoku.h"
 
 #define MAX_TRIES 80
+#define RESTART_NODES 200
+#define GENERATE_NODES 200000
+#define UA_MIN_BLANKS 52
+// Nós de cada prova de unicidade fora do 9x9; a que estoura não prova nada.
+// Em remove(), cada prova recebe SIZED_PROOF_SCALE vezes a mais longa já
+// aceita, entre SIZED_MIN_NODES e SIZED_UNIQUE_NODES.
+#define SIZED_UNIQUE_NODES 4000
+#define SIZED_MIN_NODES 256
+#define SIZED_PROOF_SCALE 4
 #define COMP_NAME "myGames"
 #define GAME_NAME "sudoku"
 
-class Board {
+typedef std::chrono::steady_clock Clock;
+
+// Sequência de Luby (1, 1, 2, 1, 1, 2, 4, ...), com i a partir de 1; os
+// reinícios dos preenchimentos têm RESTART_NODES * luby(i) nós.
+long luby(long i);
+
+// Esforço de uma busca de unicidade: nós visitados e becos sem saída (células
+// vazias sem nenhum candidato).
+struct SearchStats {
+    long nodes = 0;
+    long backtracks = 0;
+};
+
+// Casas e pares de um tabuleiro com caixas NxN, calculados pelo compilador:
+// casas 0..S-1 são linhas, S..2S-1 colunas e 2S..3S-1 caixas (S = N * N).
+template<int N>
+struct BoardGeometry {
+    static constexpr int SIDE = N * N;
+    static constexpr int CELLS = SIDE * SIDE;
+    static constexpr int UNITS = 3 * SIDE;
+    // Linha e coluna, mais o resto da caixa.
+    static constexpr int PEERS = 2 * (SIDE - 1) + (N - 1) * (N - 1);
+
+    uint16_t units[UNITS][SIDE];
+    uint16_t peers[CELLS][PEERS];
+
+    constexpr BoardGeometry() : units(), peers() {
+        for (int k = 0; k < SIDE; k++) {
+            for (int j = 0; j < SIDE; j++) {
+                units[k][j] = k * SIDE + j;
+                units[SIDE + k][j] = j * SIDE + k;
+                units[2 * SIDE + k][j] = ((k / N) * N + j / N) * SIDE + (k % N) * N + j % N;
+            }
+        }
+
+        for (int i = 0; i < CELLS; i++) {
+            int l = i / SIDE, c = i % SIDE, n = 0;
+            for (int j = 0; j < SIDE; j++) {
+                if (j != c) peers[i][n++] = l * SIDE + j;
+                if (j != l) peers[i][n++] = j * SIDE + c;
+            }
+            int top = l - l % N, left = c - c % N;
+            for (int bl = top; bl < top + N; bl++)
+                for (int bc = left; bc < left + N; bc++)
+                    if (bl != l && bc != c) peers[i][n++] = bl * SIDE + bc;
+        }
+    }
+};
+
+template<int N>
+inline constexpr BoardGeometry<N> GEOMETRY;
+
+// Candidatos para tamanhos sem o kernel SIMD do 9x9 (Candidates.h); mesmos
+// campos, com máscaras largas o bastante para S dígitos.
+template<int N>
+struct SizedCandidates {
+    typedef std::conditional_t<(N * N <= 16), uint16_t, uint32_t> Mask;
+
+    Mask mask[N * N * N * N];
+    uint8_t count[N * N * N * N];
+    int best;
+};
+
+// Tabuleiro com caixas NxN e valores 1..N*N. O 9x9 (Board) continua com os
+// caminhos próprios: regras das variantes, kernel SIMD de candidatos,
+// bitboard e conjuntos inevitáveis, escolhidos com `if constexpr`. Os outros
+// tamanhos usam as tabelas de GEOMETRY<N> numa busca por máscaras com
+// propagação. Os membros são definidos em Board.cpp, instanciados para
+// N = 2..5.
+template<int N>
+class BasicBoard {
+public:
+    static constexpr int BOX = N;
+    static constexpr int SIDE = N * N;
+    static constexpr int CELLS = SIDE * SIDE;
+
+    typedef std::array<uint8_t, CELLS> Cells;
+    typedef std::conditional_t<N == 3, Candidates, SizedCandidates<N>> CandidateSet;
+
+    // Estado completo do tabuleiro (104 bytes no 9x9, com o alinhamento do
+    // bitset), para buscas e histórico.
+    struct Snapshot {
+        uint8_t tiles[SIDE][SIDE];
+        std::bitset<CELLS> original;
+    };
 private:
-    int tiles[9][9] = {};
-    bool original[9][9] = {};
+    uint8_t tiles[SIDE][SIDE] = {};
+    std::bitset<CELLS> original;
+    // Busca que provou a unicidade do último jogo gerado por remove().
+    SearchStats effort;
 private:
     std::string get_save_path();
+
+    bool fill_rec(bool random, long& nodes, Clock::time_point deadline, const CancelToken* cancel);
 public:
 
-    Board() = default;
+    BasicBoard() = default;
+
+    Snapshot snapshot();
+
+    void restore(const Snapshot& snap);
 
     bool save(Options& opts);
 
@@ -32,29 +141,54 @@ public:
 
     void set_tile(int val, int l, int c);
 
+    Cells get_grid();
+
+    void set_grid(const Cells& grid);
+
     void clear();
 
     void consolidate();
 
     void clear_user();
 
-    bool remove(int num_remove);
+    bool remove(int num_remove, Clock::time_point deadline = Clock::time_point::max(),
+                const CancelToken* cancel = nullptr, const Progress& progress = nullptr);
 
     bool fill(bool random);
 
-    bool unique_rec(int& numSols);
+    bool fill(bool random, long max_nodes, Clock::time_point deadline = Clock::time_point::max(),
+              const CancelToken* cancel = nullptr);
+
+    bool generate(int num_remove, Clock::time_point deadline,
+                  const CancelToken* cancel = nullptr, const Progress& progress = nullptr);
+
+    // Conta soluções até 2; com `first`, guarda a primeira encontrada.
+    bool unique_rec(int& numSols, const CancelToken* cancel = nullptr, SearchStats* stats = nullptr,
+                    Cells* first = nullptr);
 
-    bool is_unique_solvable();
+    bool is_unique_solvable(const CancelToken* cancel = nullptr, SearchStats* stats = nullptr);
 
-    bool lin_has_val(int val, int lin);
+    bool is_unique_solvable(ThreadPool& pool);
 
-    bool col_has_val(int val, int col);
+    bool make_minimal(const CancelToken* cancel = nullptr);
 
-    bool block_has_val(int val, int lin, int col);
+    bool is_minimal();
+
+    const SearchStats& search_effort() const { return effort; }
+
+    // Dificuldade estimada de graça a partir das buscas que remove() já faz:
+    // os becos sem saída da busca sobre o jogo pronto.
+    int difficulty() const { return effort.backtracks; }
+
+    bool is_valid();
 
     bool is_allowed(int val, int lin, int col);
 
+    void candidates(CandidateSet& out);
+
     Coords next_empty();
 };
 
+typedef BasicBoard<3> Board;
+
 #endif //SUDOKU_BOARD_H
@@ -0,0 +1,24 @@
+#ifndef SUDOKU_CANCEL_H
+#define SUDOKU_CANCEL_H
+
+#include <atomic>
+#include <functional>
+
+// Pedido de cancelamento compartilhado entre quem dispara uma operação longa
+// e a própria operação, que consulta o token a cada nó da busca.
+class CancelToken {
+private:
+    std::atomic<bool> flag{false};
+public:
+
+    void cancel() { flag.store(true, std::memory_order_relaxed); }
+
+    void reset() { flag.store(false, std::memory_order_relaxed); }
+
+    bool cancelled() const { return flag.load(std::memory_order_relaxed); }
+};
+
+// Avanço de uma operação longa: `done` de `total` passos concluídos.
+typedef std::function<void(int done, int total)> Progress;
+
+#endif //SUDOKU_CANCEL_H
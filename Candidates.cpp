@@ -0,0 +1,187 @@
+#include "Candidates.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CANDIDATES_X86
+#include <immintrin.h>
+#endif
+
+#define ALL_DIGITS 0x1FF
+
+void house_masks(const uint8_t cells[81], uint16_t rows[9], uint16_t cols[9], uint16_t boxes[9]) {
+    for (int k = 0; k < 9; k++) rows[k] = cols[k] = boxes[k] = 0;
+
+    for (int l = 0; l < 9; l++) {
+        for (int c = 0; c < 9; c++) {
+            int val = cells[l * 9 + c];
+            if (val == 0) continue;
+            uint16_t bit = 1 << (val - 1);
+            rows[l] |= bit;
+            cols[c] |= bit;
+            boxes[(l / 3) * 3 + c / 3] |= bit;
+        }
+    }
+}
+
+// Célula da coluna 8, que sobra fora dos vetores de 8 posições.
+static inline void last_column(const uint8_t cells[81], const uint16_t rows[9], const uint16_t cols[9],
+                               const uint16_t boxes[9], int l, Candidates& out, int& best_count) {
+    int i = l * 9 + 8;
+    uint16_t mask = 0;
+    if (cells[i] == 0) mask = ALL_DIGITS & ~(rows[l] | cols[8] | boxes[(l / 3) * 3 + 2]);
+    int count = __builtin_popcount(mask);
+    out.mask[i] = mask;
+    out.count[i] = count;
+    if (cells[i] == 0 && count < best_count) {
+        best_count = count;
+        out.best = i;
+    }
+}
+
+void compute_candidates_scalar(const uint8_t cells[81], const uint16_t rows[9], const uint16_t cols[9],
+                               const uint16_t boxes[9], Candidates& out) {
+    int best_count = 10;
+    out.best = -1;
+
+    for (int l = 0; l < 9; l++) {
+        for (int c = 0; c < 9; c++) {
+            int i = l * 9 + c;
+            uint16_t mask = 0;
+            if (cells[i] == 0) mask = ALL_DIGITS & ~(rows[l] | cols[c] | boxes[(l / 3) * 3 + c / 3]);
+            int count = __builtin_popcount(mask);
+            out.mask[i] = mask;
+            out.count[i] = count;
+            if (cells[i] == 0 && count < best_count) {
+                best_count = count;
+                out.best = i;
+            }
+        }
+    }
+}
+
+#ifdef CANDIDATES_X86
+
+// Uma linha, colunas 0..7: candidatos, contagens e a menor contagem entre as
+// células vazias via _mm_minpos_epu16.
+__attribute__((target("sse4.1")))
+static inline void row_sse41(const uint8_t cells[81], const uint16_t rows[9], __m128i cols, __m128i boxes,
+                             int l, Candidates& out, int& best_count) {
+    const __m128i nibble_count = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low_nibbles = _mm_set1_epi8(0x0F);
+
+    __m128i used = _mm_or_si128(_mm_or_si128(_mm_set1_epi16(rows[l]), cols), boxes);
+    __m128i row_cells = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cells + l * 9)));
+    __m128i empty = _mm_cmpeq_epi16(row_cells, _mm_setzero_si128());
+    __m128i mask = _mm_and_si128(_mm_andnot_si128(used, _mm_set1_epi16(ALL_DIGITS)), empty);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out.mask + l * 9), mask);
+
+    __m128i lo = _mm_shuffle_epi8(nibble_count, _mm_and_si128(mask, low_nibbles));
+    __m128i hi = _mm_shuffle_epi8(nibble_count, _mm_and_si128(_mm_srli_epi16(mask, 4), low_nibbles));
+    __m128i bytes = _mm_add_epi8(lo, hi);
+    __m128i count = _mm_add_epi16(_mm_and_si128(bytes, _mm_set1_epi16(0xFF)), _mm_srli_epi16(bytes, 8));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out.count + l * 9), _mm_packus_epi16(count, count));
+
+    // Células preenchidas nunca vencem a disputa pelo mínimo.
+    __m128i key = _mm_or_si128(count, _mm_andnot_si128(empty, _mm_set1_epi16(0x10)));
+    int minpos = _mm_cvtsi128_si32(_mm_minpos_epu16(key));
+    int min_count = minpos & 0xFFFF;
+    if (min_count < best_count) {
+        best_count = min_count;
+        out.best = l * 9 + (minpos >> 16);
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void compute_candidates_sse41(const uint8_t cells[81], const uint16_t rows[9], const uint16_t cols[9],
+                                     const uint16_t boxes[9], Candidates& out) {
+    int best_count = 10;
+    out.best = -1;
+
+    __m128i col = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cols));
+    for (int l = 0; l < 9; l++) {
+        const uint16_t* band = boxes + (l / 3) * 3;
+        __m128i box = _mm_setr_epi16(band[0], band[0], band[0], band[1], band[1], band[1], band[2], band[2]);
+        row_sse41(cells, rows, col, box, l, out, best_count);
+        last_column(cells, rows, cols, boxes, l, out, best_count);
+    }
+}
+
+// Duas linhas por iteração nos registradores de 256 bits; a linha 8 sobra
+// e vai pelo caminho de 128 bits.
+__attribute__((target("avx2")))
+static void compute_candidates_avx2(const uint8_t cells[81], const uint16_t rows[9], const uint16_t cols[9],
+                                    const uint16_t boxes[9], Candidates& out) {
+    const __m256i nibble_count = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+
+    int best_count = 10;
+    out.best = -1;
+
+    __m128i col128 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cols));
+    __m256i col = _mm256_broadcastsi128_si256(col128);
+
+    __m128i box_rows[3];
+    for (int b = 0; b < 3; b++) {
+        const uint16_t* band = boxes + b * 3;
+        box_rows[b] = _mm_setr_epi16(band[0], band[0], band[0], band[1], band[1], band[1], band[2], band[2]);
+    }
+
+    for (int l = 0; l < 8; l += 2) {
+        __m256i row = _mm256_setr_m128i(_mm_set1_epi16(rows[l]), _mm_set1_epi16(rows[l + 1]));
+        __m256i box = _mm256_setr_m128i(box_rows[l / 3], box_rows[(l + 1) / 3]);
+        __m128i pair_cells = _mm_unpacklo_epi64(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(cells + l * 9)),
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(cells + (l + 1) * 9)));
+
+        __m256i used = _mm256_or_si256(_mm256_or_si256(row, col), box);
+        __m256i empty = _mm256_cmpeq_epi16(_mm256_cvtepu8_epi16(pair_cells), _mm256_setzero_si256());
+        __m256i mask = _mm256_and_si256(_mm256_andnot_si256(used, _mm256_set1_epi16(ALL_DIGITS)), empty);
+
+        __m256i lo = _mm256_shuffle_epi8(nibble_count, _mm256_and_si256(mask, low_nibbles));
+        __m256i hi = _mm256_shuffle_epi8(nibble_count, _mm256_and_si256(_mm256_srli_epi16(mask, 4), low_nibbles));
+        __m256i bytes = _mm256_add_epi8(lo, hi);
+        __m256i count = _mm256_add_epi16(_mm256_and_si256(bytes, _mm256_set1_epi16(0xFF)),
+                                         _mm256_srli_epi16(bytes, 8));
+        __m256i key = _mm256_or_si256(count, _mm256_andnot_si256(empty, _mm256_set1_epi16(0x10)));
+
+        for (int half = 0; half < 2; half++) {
+            int r = l + half;
+            __m128i half_mask = half ? _mm256_extracti128_si256(mask, 1) : _mm256_castsi256_si128(mask);
+            __m128i half_count = half ? _mm256_extracti128_si256(count, 1) : _mm256_castsi256_si128(count);
+            __m128i half_key = half ? _mm256_extracti128_si256(key, 1) : _mm256_castsi256_si128(key);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out.mask + r * 9), half_mask);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out.count + r * 9), _mm_packus_epi16(half_count, half_count));
+
+            int minpos = _mm_cvtsi128_si32(_mm_minpos_epu16(half_key));
+            int min_count = minpos & 0xFFFF;
+            if (min_count < best_count) {
+                best_count = min_count;
+                out.best = r * 9 + (minpos >> 16);
+            }
+            last_column(cells, rows, cols, boxes, r, out, best_count);
+        }
+    }
+
+    row_sse41(cells, rows, col128, box_rows[2], 8, out, best_count);
+    last_column(cells, rows, cols, boxes, 8, out, best_count);
+}
+
+#endif
+
+typedef void (*CandidatesKernel)(const uint8_t*, const uint16_t*, const uint16_t*, const uint16_t*, Candidates&);
+
+static CandidatesKernel select_kernel() {
+#ifdef CANDIDATES_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return compute_candidates_avx2;
+    if (__builtin_cpu_supports("sse4.1")) return compute_candidates_sse41;
+#endif
+    return compute_candidates_scalar;
+}
+
+void compute_candidates(const uint8_t cells[81], const uint16_t rows[9], const uint16_t cols[9],
+                        const uint16_t boxes[9], Candidates& out) {
+    static const CandidatesKernel kernel = select_kernel();
+    kernel(cells, rows, cols, boxes, out);
+}
@@ -0,0 +1,25 @@
+#ifndef SUDOKU_CANDIDATES_H
+#define SUDOKU_CANDIDATES_H
+
+#include <cstdint>
+
+// Candidatos de todas as células de uma vez: bit (v - 1) de mask[i] indica
+// que o valor v é permitido na célula i. Células preenchidas ficam com
+// máscara e contagem zero. `best` é a célula vazia com menos candidatos
+// (a primeira em caso de empate), ou -1 se não há células vazias.
+struct Candidates {
+    uint16_t mask[81];
+    uint8_t count[81];
+    int best;
+};
+
+void house_masks(const uint8_t cells[81], uint16_t rows[9], uint16_t cols[9], uint16_t boxes[9]);
+
+// Usa SSE4.1 ou AVX2 quando o processador tem, escolhido em tempo de execução.
+void compute_candidates(const uint8_t cells[81], const uint16_t rows[9], const uint16_t cols[9],
+                        const uint16_t boxes[9], Candidates& out);
+
+void compute_candidates_scalar(const uint8_t cells[81], const uint16_t rows[9], const uint16_t cols[9],
+                               const uint16_t boxes[9], Candidates& out);
+
+#endif //SUDOKU_CANDIDATES_H
@@ -0,0 +1,255 @@
+#include "Codec.h"
+
+#include <cassert>
+#include <cstring>
+
+#define CHUNK_DIGITS 20
+
+typedef unsigned __int128 uint128;
+
+// Menor número de bytes que comporta k dígitos em base 9.
+static size_t chunk_bytes(int k) {
+    uint128 pow9 = 1, limit = 1;
+    for (int i = 0; i < k; i++) pow9 *= 9;
+    size_t bytes = 0;
+    while (limit < pow9) {
+        limit <<= 8;
+        bytes++;
+    }
+    return bytes;
+}
+
+size_t puzzle_code_size(int num_clues) {
+    size_t size = CLUE_MAP_SIZE;
+    for (; num_clues > 0; num_clues -= CHUNK_DIGITS)
+        size += chunk_bytes(num_clues < CHUNK_DIGITS ? num_clues : CHUNK_DIGITS);
+    return size;
+}
+
+size_t encode_puzzle(const Grid& puzzle, uint8_t* out) {
+    std::memset(out, 0, CLUE_MAP_SIZE);
+
+    uint8_t digits[81];
+    int n = 0;
+    for (int i = 0; i < 81; i++) {
+        if (puzzle[i] == 0) continue;
+        out[i / 8] |= 1 << (i % 8);
+        digits[n++] = puzzle[i] - 1;
+    }
+
+    size_t pos = CLUE_MAP_SIZE;
+    for (int start = 0; start < n; start += CHUNK_DIGITS) {
+        int k = n - start < CHUNK_DIGITS ? n - start : CHUNK_DIGITS;
+        uint64_t chunk = 0;
+        for (int j = k - 1; j >= 0; j--) chunk = chunk * 9 + digits[start + j];
+
+        size_t bytes = chunk_bytes(k);
+        for (size_t b = 0; b < bytes; b++) out[pos++] = chunk >> (8 * b);
+    }
+    return pos;
+}
+
+size_t decode_puzzle(const uint8_t* in, size_t size, Grid& puzzle) {
+    puzzle = {};
+    if (size < CLUE_MAP_SIZE) return 0;
+
+    int cells[81];
+    int n = 0;
+    for (int i = 0; i < 81; i++)
+        if (in[i / 8] & (1 << (i % 8))) cells[n++] = i;
+    if (puzzle_code_size(n) > size) return 0;
+
+    size_t pos = CLUE_MAP_SIZE;
+    for (int start = 0; start < n; start += CHUNK_DIGITS) {
+        int k = n - start < CHUNK_DIGITS ? n - start : CHUNK_DIGITS;
+
+        size_t bytes = chunk_bytes(k);
+        uint64_t chunk = 0;
+        for (size_t b = 0; b < bytes; b++) chunk |= (uint64_t) in[pos++] << (8 * b);
+
+        for (int j = 0; j < k; j++) {
+            puzzle[cells[start + j]] = 1 + chunk % 9;
+            chunk /= 9;
+        }
+    }
+    return pos;
+}
+
+// Estado usado pela codificação da solução. Codificador e decodificador
+// percorrem as células na mesma ordem e propagam da mesma forma, então
+// enxergam exatamente os mesmos candidatos em cada passo.
+struct CodecState {
+    uint8_t cells[81];
+    uint16_t rows[9];
+    uint16_t cols[9];
+    uint16_t boxes[9];
+
+    void place(int i, int d) {
+        int l = i / 9, c = i % 9;
+        cells[i] = d + 1;
+        rows[l] |= 1 << d;
+        cols[c] |= 1 << d;
+        boxes[(l / 3) * 3 + c / 3] |= 1 << d;
+    }
+
+    uint16_t candidates(int i) {
+        int l = i / 9, c = i % 9;
+        return 0x1FF & ~(rows[l] | cols[c] | boxes[(l / 3) * 3 + c / 3]);
+    }
+};
+
+static int house_cells(int h, int k) {
+    if (h < 9) return h * 9 + k;
+    if (h < 18) return k * 9 + (h - 9);
+    h -= 18;
+    return ((h / 3) * 3 + k / 3) * 9 + (h % 3) * 3 + k % 3;
+}
+
+// Únicos nus e ocultos até o ponto fixo; falso em contradição.
+static bool propagate(CodecState& s) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (int i = 0; i < 81; i++) {
+            if (s.cells[i] != 0) continue;
+            uint16_t mask = s.candidates(i);
+            if (mask == 0) return false;
+            if ((mask & (mask - 1)) == 0) {
+                s.place(i, __builtin_ctz(mask));
+                changed = true;
+            }
+        }
+
+        for (int h = 0; h < 27; h++) {
+            uint16_t once = 0, twice = 0, placed = 0;
+            for (int k = 0; k < 9; k++) {
+                int i = house_cells(h, k);
+                if (s.cells[i] != 0) {
+                    placed |= 1 << (s.cells[i] - 1);
+                    continue;
+                }
+                uint16_t mask = s.candidates(i);
+                twice |= once & mask;
+                once |= mask;
+            }
+            if ((once | placed) != 0x1FF) return false;
+
+            uint16_t single = once & ~twice & ~placed;
+            if (single == 0) continue;
+            for (int k = 0; k < 9; k++) {
+                int i = house_cells(h, k);
+                if (s.cells[i] != 0) continue;
+                uint16_t mask = s.candidates(i) & single;
+                if (mask == 0) continue;
+                if (mask & (mask - 1)) return false;
+                s.place(i, __builtin_ctz(mask));
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
+
+// Candidatos da célula i que não levam a contradição imediata. Na primeira
+// banda a propagação quase nunca corta nada, então nem tentamos.
+static int viable(CodecState& s, int i, uint8_t options[9]) {
+    int n = 0;
+    uint16_t mask = s.candidates(i);
+    for (int d = 0; d < 9; d++) {
+        if (!(mask & (1 << d))) continue;
+        if (i >= 27) {
+            CodecState t = s;
+            t.place(i, d);
+            if (!propagate(t)) continue;
+        }
+        options[n++] = d;
+    }
+    return n;
+}
+
+bool encode_solution(const Grid& solution, uint8_t* out) {
+    CodecState s = {};
+    uint8_t radix[81], digit[81];
+    int n = 0;
+
+    for (int i = 0; i < 81; i++) {
+        if (solution[i] < 1 || solution[i] > 9) return false;
+        if (s.cells[i] != 0) {
+            if (s.cells[i] != solution[i]) return false;
+            continue;
+        }
+
+        uint8_t options[9];
+        int count = viable(s, i, options);
+        int k = 0;
+        while (k < count && options[k] != solution[i] - 1) k++;
+        if (k == count) return false;
+
+        radix[n] = count;
+        digit[n] = k;
+        n++;
+
+        s.place(i, solution[i] - 1);
+        if (!propagate(s)) return false;
+    }
+
+    uint128 value = 0;
+    for (int j = n - 1; j >= 0; j--) value = value * radix[j] + digit[j];
+    // Ver a cota em Codec.h.
+    assert((value >> (8 * SOLUTION_CODE_SIZE)) == 0);
+
+    for (int b = 0; b < SOLUTION_CODE_SIZE; b++) out[b] = value >> (8 * b);
+    return true;
+}
+
+bool decode_solution(const uint8_t* in, Grid& solution) {
+    uint128 value = 0;
+    for (int b = 0; b < SOLUTION_CODE_SIZE; b++) value |= (uint128) in[b] << (8 * b);
+
+    CodecState s = {};
+    for (int i = 0; i < 81; i++) {
+        if (s.cells[i] != 0) continue;
+
+        uint8_t options[9];
+        int count = viable(s, i, options);
+        if (count == 0) return false;
+
+        s.place(i, options[value % count]);
+        value /= count;
+        if (!propagate(s)) return false;
+    }
+
+    std::memcpy(solution.data(), s.cells, 81);
+    return value == 0;
+}
+
+size_t encode_puzzles(const Grid* puzzles, size_t count, uint8_t* out) {
+    size_t pos = 0;
+    for (size_t i = 0; i < count; i++) pos += encode_puzzle(puzzles[i], out + pos);
+    return pos;
+}
+
+size_t decode_puzzles(const uint8_t* in, size_t size, size_t count, Grid* puzzles) {
+    size_t pos = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t used = decode_puzzle(in + pos, size - pos, puzzles[i]);
+        if (used == 0) return 0;
+        pos += used;
+    }
+    return pos;
+}
+
+bool encode_solutions(const Grid* solutions, size_t count, uint8_t* out) {
+    for (size_t i = 0; i < count; i++)
+        if (!encode_solution(solutions[i], out + i * SOLUTION_CODE_SIZE))
+            return false;
+    return true;
+}
+
+bool decode_solutions(const uint8_t* in, size_t count, Grid* solutions) {
+    for (size_t i = 0; i < count; i++)
+        if (!decode_solution(in + i * SOLUTION_CODE_SIZE, solutions[i]))
+            return false;
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef SUDOKU_CODEC_H
+#define SUDOKU_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sudoku.h"
+
+// Tabuleiro: mapa de 81 bits das pistas seguido dos dígitos das pistas em
+// base 9, em blocos de até 20 dígitos por uint64_t (só os bytes necessários).
+#define CLUE_MAP_SIZE 11
+#define PUZZLE_CODE_MAX 44
+
+// Solução: número em base mista, cada célula codificada pela posição do seu
+// valor entre os candidatos que sobrevivem à propagação de únicos. Fica em
+// média com 73 bits, mas a cauda passa de 79 (e nenhum código fixo cabe em 9
+// bytes: são 6,67e21 grades > 2^72). Cada base é no máximo o número de
+// candidatos deixados pelas células anteriores na ordem de linhas; o máximo
+// desse produto, enumerado banda a banda sobre todas as bandas (com a
+// primeira linha fixada a menos de troca de dígitos), é 2^42,63 na primeira,
+// 2^37,07 na segunda (para qualquer trio acima de cada coluna) e 2^13,76 na
+// terceira. O código fica abaixo de 2^93,5 e cabe em 12 bytes.
+#define SOLUTION_CODE_SIZE 12
+
+size_t puzzle_code_size(int num_clues);
+
+size_t encode_puzzle(const Grid& puzzle, uint8_t* out);
+
+// Lê no máximo `size` bytes; 0 se o mapa de pistas pede um código maior.
+size_t decode_puzzle(const uint8_t* in, size_t size, Grid& puzzle);
+
+// Falso só se a grade não é uma solução válida.
+bool encode_solution(const Grid& solution, uint8_t* out);
+
+bool decode_solution(const uint8_t* in, Grid& solution);
+
+// Versões em lote sobre buffers contíguos. Os códigos de tabuleiro são
+// concatenados (tamanho variável); os de solução têm passo fixo.
+size_t encode_puzzles(const Grid* puzzles, size_t count, uint8_t* out);
+
+// 0 se algum código passa do fim do buffer.
+size_t decode_puzzles(const uint8_t* in, size_t size, size_t count, Grid* puzzles);
+
+bool encode_solutions(const Grid* solutions, size_t count, uint8_t* out);
+
+bool decode_solutions(const uint8_t* in, size_t count, Grid* solutions);
+
+#endif //SUDOKU_CODEC_H
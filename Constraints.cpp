@@ -0,0 +1,106 @@
+#include "Constraints.h"
+
+// Regiões do jigsaw embutido, em ordem de linhas.
+static const char JIGSAW_REGIONS[] =
+        "000011112"
+        "000012222"
+        "011115552"
+        "333333522"
+        "343443552"
+        "644444555"
+        "664678888"
+        "666677778"
+        "677778888";
+
+const char* variant_name(int variant) {
+    static const char* names[NUM_VARIANTS] = {"clássico", "diagonal", "windoku", "jigsaw"};
+    return variant >= 0 && variant < NUM_VARIANTS ? names[variant] : "?";
+}
+
+ConstraintTable::ConstraintTable(Variant variant, const char* regions) {
+    for (int i = 0; i < 81; i++) {
+        int l = i / 9, c = i % 9;
+        box_of[i] = regions != nullptr ? regions[i] - '0' : (l / 3) * 3 + c / 3;
+    }
+    kernel_houses = regions != nullptr ? 18 : 27;
+
+    int filled[CT_MAX_HOUSES] = {};
+    auto add = [&](int h, int cell) { houses[h][filled[h]++] = cell; };
+    for (int i = 0; i < 81; i++) {
+        add(i / 9, i);
+        add(9 + i % 9, i);
+        add(18 + box_of[i], i);
+    }
+    num_houses = 27;
+
+    if (variant == VARIANT_DIAGONAL) {
+        for (int k = 0; k < 9; k++) {
+            add(27, k * 9 + k);
+            add(28, k * 9 + 8 - k);
+        }
+        num_houses = 29;
+    } else if (variant == VARIANT_WINDOKU) {
+        const int corners[4] = {10, 14, 46, 50};
+        for (int w = 0; w < 4; w++)
+            for (int k = 0; k < 9; k++)
+                add(27 + w, corners[w] + (k / 3) * 9 + k % 3);
+        num_houses = 31;
+    }
+
+    for (int i = 0; i < 81; i++) num_cell_houses[i] = 0;
+    for (int h = 0; h < num_houses; h++) {
+        house_mask[h] = Bits81();
+        for (int cell : houses[h]) {
+            house_mask[h] |= Bits81::cell(cell);
+            cell_houses[cell][num_cell_houses[cell]++] = h;
+        }
+    }
+
+    for (int i = 0; i < 81; i++) {
+        Bits81 p;
+        for (int k = 0; k < num_cell_houses[i]; k++) p |= house_mask[cell_houses[i][k]];
+        peer_mask[i] = p.minus(Bits81::cell(i));
+
+        num_peers[i] = 0;
+        for (Bits81 rest = peer_mask[i]; rest.any();) {
+            int j = rest.first();
+            rest = rest.minus(Bits81::cell(j));
+            peers[i][num_peers[i]++] = j;
+        }
+    }
+}
+
+void ConstraintTable::restrict(const uint8_t cells[81], Candidates& out) const {
+    for (int h = kernel_houses; h < num_houses; h++) {
+        uint16_t used = 0;
+        for (int cell : houses[h])
+            if (cells[cell] != 0) used |= 1 << (cells[cell] - 1);
+        for (int cell : houses[h]) {
+            out.mask[cell] &= ~used;
+            out.count[cell] = __builtin_popcount(out.mask[cell]);
+        }
+    }
+
+    // A célula de menos candidatos pode ter mudado; empate fica com a primeira.
+    int best_count = 10;
+    out.best = -1;
+    for (int i = 0; i < 81; i++) {
+        if (cells[i] == 0 && out.count[i] < best_count) {
+            best_count = out.count[i];
+            out.best = i;
+        }
+    }
+}
+
+static const ConstraintTable TABLES[NUM_VARIANTS] = {
+        ConstraintTable(VARIANT_CLASSIC),
+        ConstraintTable(VARIANT_DIAGONAL),
+        ConstraintTable(VARIANT_WINDOKU),
+        ConstraintTable(VARIANT_JIGSAW, JIGSAW_REGIONS),
+};
+
+const ConstraintTable* active_rules = &TABLES[VARIANT_CLASSIC];
+
+void set_variant(int variant) {
+    active_rules = &TABLES[variant];
+}
@@ -0,0 +1,59 @@
+#ifndef SUDOKU_CONSTRAINTS_H
+#define SUDOKU_CONSTRAINTS_H
+
+#include <cstdint>
+
+#include "BitBoard.h"
+#include "Candidates.h"
+#include "sudoku.h"
+
+// Linhas, colunas e caixas mais até 4 casas extras (as janelas do windoku).
+#define CT_MAX_HOUSES 31
+// Casas de uma célula: no máximo a do centro da diagonal, em 5.
+#define CT_MAX_CELL_HOUSES 5
+// Pares de uma célula: no máximo também o centro da diagonal, com 32.
+#define CT_MAX_PEERS 32
+
+enum Variant {
+    VARIANT_CLASSIC,
+    VARIANT_DIAGONAL,
+    VARIANT_WINDOKU,
+    VARIANT_JIGSAW,
+    NUM_VARIANTS
+};
+
+const char* variant_name(int variant);
+
+// Regras de um tabuleiro 9x9 como dados: as casas (grupos de 9 células sem
+// dígito repetido), as casas de cada célula e seus pares, em listas e em
+// máscaras. As casas 0..8 são as linhas, 9..17 as colunas, 18..26 as caixas
+// (regiões no jigsaw) e as seguintes, extras. Quem verifica ou propaga só
+// percorre as listas, sem nunca perguntar qual é a variante.
+struct ConstraintTable {
+    int num_houses;
+    uint8_t houses[CT_MAX_HOUSES][9];
+    Bits81 house_mask[CT_MAX_HOUSES];
+    uint8_t box_of[81];
+    uint8_t num_cell_houses[81];
+    uint8_t cell_houses[81][CT_MAX_CELL_HOUSES];
+    uint8_t num_peers[81];
+    uint8_t peers[81][CT_MAX_PEERS];
+    Bits81 peer_mask[81];
+    // Casas que o kernel de candidatos já cobre: 27 com as caixas comuns,
+    // 18 quando as caixas são regiões irregulares.
+    int kernel_houses;
+
+    ConstraintTable(Variant variant, const char* regions = nullptr);
+
+    // Tira dos candidatos os dígitos das casas que o kernel não cobre.
+    void restrict(const uint8_t cells[81], Candidates& out) const;
+};
+
+// Regras em uso. Só mudam entre jogos, nunca com uma busca em andamento.
+extern const ConstraintTable* active_rules;
+
+inline const ConstraintTable& rules() { return *active_rules; }
+
+void set_variant(int variant);
+
+#endif //SUDOKU_CONSTRAINTS_H
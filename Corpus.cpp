@@ -0,0 +1,141 @@
+#include "Corpus.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "Codec.h"
+
+bool Corpus::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+
+    size_t length = file.size();
+    const uint8_t* base = file.bytes();
+    if (length < sizeof(CorpusHeader)) {
+        close();
+        return false;
+    }
+
+    const CorpusHeader* head = reinterpret_cast<const CorpusHeader*>(base);
+    if (std::memcmp(head->magic, CORPUS_MAGIC, 4) != 0 || head->version != CORPUS_VERSION ||
+        head->record_size < sizeof(uint16_t) + CLUE_MAP_SIZE ||
+        head->record_size > sizeof(uint16_t) + PUZZLE_CODE_MAX) {
+        close();
+        return false;
+    }
+
+    size_t index_size = ((size_t) head->num_levels + 1) * sizeof(uint64_t);
+    if ((length - sizeof(CorpusHeader)) / sizeof(uint64_t) < (size_t) head->num_levels + 1) {
+        close();
+        return false;
+    }
+
+    // O índice precisa ser não decrescente; senão size() daria a volta e get()
+    // leria fora do mapeamento.
+    const uint64_t* idx = reinterpret_cast<const uint64_t*>(base + sizeof(CorpusHeader));
+    for (uint32_t d = 0; d < head->num_levels; d++) {
+        if (idx[d] > idx[d + 1]) {
+            close();
+            return false;
+        }
+    }
+
+    size_t available = length - sizeof(CorpusHeader) - index_size;
+    if (idx[head->num_levels] > available / head->record_size) {
+        close();
+        return false;
+    }
+
+    header = head;
+    index = idx;
+    records = base + sizeof(CorpusHeader) + index_size;
+    return true;
+}
+
+void Corpus::close() {
+    file.close();
+    header = nullptr;
+    index = nullptr;
+    records = nullptr;
+}
+
+bool Corpus::is_open() {
+    return header != nullptr;
+}
+
+int Corpus::num_levels() {
+    return is_open() ? header->num_levels : 0;
+}
+
+uint64_t Corpus::size(int level) {
+    if (level < 0 || level >= num_levels()) return 0;
+    return index[level + 1] - index[level];
+}
+
+// Fora dos limites devolve um tabuleiro vazio.
+Grid Corpus::get(int level, uint64_t i) {
+    Grid grid = {};
+    if (i >= size(level)) return grid;
+    decode_puzzle(records + (index[level] + i) * header->record_size + sizeof(uint16_t),
+                  header->record_size - sizeof(uint16_t), grid);
+    return grid;
+}
+
+int Corpus::effort(int level, uint64_t i) {
+    if (i >= size(level)) return 0;
+    const uint8_t* record = records + (index[level] + i) * header->record_size;
+    return record[0] | (record[1] << 8);
+}
+
+bool Corpus::pick(int level, Grid& grid) {
+    uint64_t n = size(level);
+    if (n == 0) return false;
+
+    uint64_t r = ((uint64_t) rand() << 31) ^ (uint64_t) rand();
+    grid = get(level, r % n);
+    return true;
+}
+
+bool Corpus::write(const std::string& path, const std::vector<std::vector<CorpusEntry>>& levels) {
+    std::ofstream fptr(path, std::ios::binary);
+    if (!fptr.is_open()) return false;
+
+    // Todos os registros ficam com o tamanho do maior código.
+    size_t code_size = CLUE_MAP_SIZE;
+    for (auto& level : levels) {
+        for (auto& entry : level) {
+            int clues = 0;
+            for (uint8_t val : entry.grid) clues += val != 0;
+            code_size = std::max(code_size, puzzle_code_size(clues));
+        }
+    }
+    size_t record_size = sizeof(uint16_t) + code_size;
+
+    CorpusHeader head = {};
+    std::memcpy(head.magic, CORPUS_MAGIC, 4);
+    head.version = CORPUS_VERSION;
+    head.record_size = record_size;
+    head.num_levels = levels.size();
+    fptr.write(reinterpret_cast<const char*>(&head), sizeof(head));
+
+    uint64_t offset = 0;
+    for (auto& level : levels) {
+        fptr.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        offset += level.size();
+    }
+    fptr.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+
+    for (auto& level : levels) {
+        for (auto& entry : level) {
+            uint8_t record[sizeof(uint16_t) + PUZZLE_CODE_MAX] = {};
+            record[0] = entry.effort & 0xFF;
+            record[1] = entry.effort >> 8;
+            encode_puzzle(entry.grid, record + sizeof(uint16_t));
+            fptr.write(reinterpret_cast<const char*>(record), record_size);
+        }
+    }
+
+    return fptr.good();
+}
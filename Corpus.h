@@ -0,0 +1,61 @@
+#ifndef SUDOKU_CORPUS_H
+#define SUDOKU_CORPUS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "sudoku.h"
+
+#define CORPUS_MAGIC "SDKC"
+#define CORPUS_VERSION 3
+
+// Layout do arquivo (little-endian):
+//   CorpusHeader
+//   uint64_t index[num_levels + 1]  -- registros do nível d: [index[d], index[d + 1])
+//   registros de record_size bytes, agrupados por nível; cada um é o esforço
+//   (uint16_t, ver Board::difficulty) seguido de um código de encode_puzzle()
+//   completado com zeros até record_size.
+struct CorpusEntry {
+    Grid grid;
+    uint16_t effort;
+};
+
+struct CorpusHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t num_levels;
+};
+
+class Corpus {
+private:
+    MappedFile file;
+    const CorpusHeader* header = nullptr;
+    const uint64_t* index = nullptr;
+    const uint8_t* records = nullptr;
+public:
+
+    Corpus() = default;
+
+    bool open(const std::string& path);
+
+    void close();
+
+    bool is_open();
+
+    int num_levels();
+
+    uint64_t size(int level);
+
+    Grid get(int level, uint64_t i);
+
+    int effort(int level, uint64_t i);
+
+    bool pick(int level, Grid& grid);
+
+    static bool write(const std::string& path, const std::vector<std::vector<CorpusEntry>>& levels);
+};
+
+#endif //SUDOKU_CORPUS_H
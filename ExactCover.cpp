@@ -0,0 +1,125 @@
+#include "ExactCover.h"
+
+// Coluna 0 é a raiz; as colunas 1..num_cols são os cabeçalhos.
+ExactCover::ExactCover(const Grid& puzzle) {
+    const ConstraintTable& table = rules();
+    int num_cols = 81 + table.num_houses * 9;
+
+    for (int c = 0; c <= num_cols; c++) {
+        left[c] = c == 0 ? num_cols : c - 1;
+        right[c] = c == num_cols ? 0 : c + 1;
+        up[c] = down[c] = c;
+        column[c] = c;
+        row_of[c] = -1;
+        size[c] = 0;
+    }
+
+    int node = num_cols + 1;
+    for (int r = 0; r < EC_ROWS; r++) {
+        int i = r / 9, d = r % 9;
+        int n = 1 + table.num_cell_houses[i];
+        int cols[1 + CT_MAX_CELL_HOUSES] = {1 + i};
+        for (int k = 1; k < n; k++) cols[k] = 1 + 81 + table.cell_houses[i][k - 1] * 9 + d;
+
+        int first = node;
+        row_start[r] = first;
+        for (int k = 0; k < n; k++, node++) {
+            int col = cols[k];
+            column[node] = col;
+            row_of[node] = r;
+            up[node] = up[col];
+            down[node] = col;
+            down[up[col]] = node;
+            up[col] = node;
+            size[col]++;
+
+            left[node] = k == 0 ? first + n - 1 : node - 1;
+            right[node] = k == n - 1 ? first : node + 1;
+        }
+    }
+    row_start[EC_ROWS] = node;
+
+    // Escolhe as linhas das pistas; pistas em conflito tornam o tabuleiro inviável.
+    bool covered[EC_COLS + 1] = {};
+    for (int i = 0; i < 81; i++) {
+        if (puzzle[i] == 0) continue;
+        if (puzzle[i] > 9) {
+            feasible = false;
+            return;
+        }
+        givens[i] = puzzle[i];
+
+        int r = i * 9 + puzzle[i] - 1;
+        for (int k = row_start[r]; k < row_start[r + 1]; k++) {
+            if (covered[column[k]]) {
+                feasible = false;
+                return;
+            }
+        }
+        for (int k = row_start[r]; k < row_start[r + 1]; k++) {
+            covered[column[k]] = true;
+            cover(column[k]);
+        }
+    }
+}
+
+void ExactCover::cover(int c) {
+    right[left[c]] = right[c];
+    left[right[c]] = left[c];
+    for (int i = down[c]; i != c; i = down[i]) {
+        for (int j = right[i]; j != i; j = right[j]) {
+            down[up[j]] = down[j];
+            up[down[j]] = up[j];
+            size[column[j]]--;
+        }
+    }
+}
+
+void ExactCover::uncover(int c) {
+    for (int i = up[c]; i != c; i = up[i]) {
+        for (int j = left[i]; j != i; j = left[j]) {
+            size[column[j]]++;
+            down[up[j]] = j;
+            up[down[j]] = j;
+        }
+    }
+    right[left[c]] = c;
+    left[right[c]] = c;
+}
+
+void ExactCover::search(int limit, int& count, Grid* solution, const CancelToken* cancel) {
+    if (cancel && cancel->cancelled()) return;
+
+    if (right[0] == 0) {
+        if (count == 0 && solution != nullptr) {
+            *solution = givens;
+            for (int k = 0; k < depth; k++) (*solution)[chosen[k] / 9] = chosen[k] % 9 + 1;
+        }
+        count++;
+        return;
+    }
+
+    int best = right[0];
+    for (int c = right[best]; c != 0; c = right[c])
+        if (size[c] < size[best]) best = c;
+    if (size[best] == 0) return;
+
+    cover(best);
+    for (int r = down[best]; r != best && count < limit; r = down[r]) {
+        chosen[depth++] = row_of[r];
+        for (int j = right[r]; j != r; j = right[j]) cover(column[j]);
+
+        search(limit, count, solution, cancel);
+
+        for (int j = left[r]; j != r; j = left[j]) uncover(column[j]);
+        depth--;
+    }
+    uncover(best);
+}
+
+int ExactCover::count_solutions(int limit, Grid* solution, const CancelToken* cancel) {
+    if (!feasible) return 0;
+    int count = 0;
+    search(limit, count, solution, cancel);
+    return count;
+}
@@ -0,0 +1,39 @@
+#ifndef SUDOKU_EXACTCOVER_H
+#define SUDOKU_EXACTCOVER_H
+
+#include "Cancel.h"
+#include "Constraints.h"
+#include "sudoku.h"
+
+#define EC_COLS (81 + CT_MAX_HOUSES * 9)
+#define EC_ROWS 729
+#define EC_NODES (1 + EC_COLS + EC_ROWS * (1 + CT_MAX_CELL_HOUSES))
+
+// Sudoku como cobertura exata (Algoritmo X com dancing links): 729 linhas
+// (célula, dígito) e uma coluna por célula mais uma por (casa, dígito), com
+// as casas das regras em uso; no clássico são as 324 de sempre. As pistas
+// já entram escolhidas.
+class ExactCover {
+private:
+    int left[EC_NODES], right[EC_NODES], up[EC_NODES], down[EC_NODES];
+    int column[EC_NODES], row_of[EC_NODES];
+    int size[EC_COLS + 1];
+    int row_start[EC_ROWS + 1];
+    int chosen[81];
+    int depth = 0;
+    bool feasible = true;
+    Grid givens = {};
+private:
+    void cover(int c);
+
+    void uncover(int c);
+
+    void search(int limit, int& count, Grid* solution, const CancelToken* cancel);
+public:
+
+    explicit ExactCover(const Grid& puzzle);
+
+    int count_solutions(int limit, Grid* solution = nullptr, const CancelToken* cancel = nullptr);
+};
+
+#endif //SUDOKU_EXACTCOVER_H
@@ -0,0 +1,497 @@
+#include "Grader.h"
+
+#include <algorithm>
+#include <vector>
+
+#define ALL_DIGITS 0x1FF
+
+static const char* GRADE_NAMES[NUM_GRADES] = {
+        "únicos", "pares apontados", "linha-caixa", "subconjuntos", "peixes",
+        "asas", "cadeias X", "cadeias alternadas", "tentativa"
+};
+
+const char* grade_name(int grade) {
+    return grade >= 0 && grade < NUM_GRADES ? GRADE_NAMES[grade] : "?";
+}
+
+// Encontro de uma caixa com uma linha ou coluna: as 3 células em comum e as
+// 6 que sobram de cada lado.
+struct Intersection {
+    uint8_t inter[3];
+    uint8_t box_rest[6];
+    uint8_t line_rest[6];
+};
+
+static struct GraderTables {
+    // Linhas 0..8, colunas 9..17, caixas 18..26.
+    uint8_t houses[27][9];
+    uint8_t peers[81][20];
+    // Casas de cada célula (linha, coluna, caixa) e a posição dela em cada uma.
+    uint8_t house_of[81][3];
+    uint8_t index_in[81][3];
+    Bits81 peer_bits[81];
+    Intersection intersections[54];
+    // Subconjuntos de 9 posições com 2, 3 e 4 elementos.
+    std::vector<uint16_t> subsets[5];
+
+    GraderTables() {
+        for (int k = 0; k < 9; k++) {
+            for (int j = 0; j < 9; j++) {
+                houses[k][j] = k * 9 + j;
+                houses[9 + k][j] = j * 9 + k;
+                houses[18 + k][j] = ((k / 3) * 3 + j / 3) * 9 + (k % 3) * 3 + j % 3;
+            }
+        }
+
+        for (int h = 0; h < 27; h++) {
+            for (int j = 0; j < 9; j++) {
+                int cell = houses[h][j];
+                house_of[cell][h / 9] = h;
+                index_in[cell][h / 9] = j;
+            }
+        }
+
+        for (int i = 0; i < 81; i++) {
+            int n = 0;
+            for (int p = 0; p < 81; p++) {
+                if (p == i) continue;
+                bool row = p / 9 == i / 9;
+                bool col = p % 9 == i % 9;
+                bool box = (p / 27 == i / 27) && ((p % 9) / 3 == (i % 9) / 3);
+                if (row || col || box) {
+                    peers[i][n++] = p;
+                    peer_bits[i] |= Bits81::cell(p);
+                }
+            }
+        }
+
+        int n = 0;
+        for (int b = 0; b < 9; b++) {
+            for (int line = 0; line < 18; line++) {
+                const uint8_t* box = houses[18 + b];
+                const uint8_t* cells = houses[line];
+                auto in_line = [&](int cell) { return std::find(cells, cells + 9, cell) != cells + 9; };
+                auto in_box = [&](int cell) { return std::find(box, box + 9, cell) != box + 9; };
+
+                int shared = 0, box_rest = 0, line_rest = 0;
+                for (int j = 0; j < 9; j++) if (in_line(box[j])) shared++;
+                if (shared != 3) continue;
+
+                Intersection& it = intersections[n++];
+                shared = 0;
+                for (int j = 0; j < 9; j++) {
+                    if (in_line(box[j])) it.inter[shared++] = box[j];
+                    else it.box_rest[box_rest++] = box[j];
+                    if (!in_box(cells[j])) it.line_rest[line_rest++] = cells[j];
+                }
+            }
+        }
+
+        for (int s = 0; s < 512; s++) {
+            int k = __builtin_popcount(s);
+            if (k >= 2 && k <= 4) subsets[k].push_back(s);
+        }
+    }
+} TABLES;
+
+LogicSolver::LogicSolver(const Grid& puzzle) : unsolved(81), broken(false) {
+    for (int i = 0; i < 81; i++) {
+        cells[i] = 0;
+        cand[i] = ALL_DIGITS;
+    }
+    for (auto& house : where)
+        for (auto& spots : house) spots = ALL_DIGITS;
+    for (auto& plane : planes) plane = Bits81(~0ULL, (1ULL << 17) - 1);
+    for (int i = 0; i < 81 && !broken; i++)
+        if (puzzle[i] != 0) place(i, puzzle[i]);
+}
+
+// Tira o candidato `digit` (0..8) da célula no grafo de ligações.
+void LogicSolver::unlink(int cell, int digit) {
+    planes[digit] = planes[digit].minus(Bits81::cell(cell));
+    for (int k = 0; k < 3; k++)
+        where[TABLES.house_of[cell][k]][digit] &= ~(1 << TABLES.index_in[cell][k]);
+}
+
+bool LogicSolver::place(int cell, int digit) {
+    uint16_t bit = 1 << (digit - 1);
+    if (!(cand[cell] & bit)) {
+        broken = true;
+        return false;
+    }
+
+    for (uint16_t m = cand[cell]; m; m &= m - 1) unlink(cell, __builtin_ctz(m));
+    cells[cell] = digit;
+    cand[cell] = 0;
+    unsolved--;
+    for (int p : TABLES.peers[cell]) {
+        if (cells[p] == 0 && (cand[p] & bit)) {
+            cand[p] &= ~bit;
+            unlink(p, digit - 1);
+            if (cand[p] == 0) broken = true;
+        }
+    }
+    return true;
+}
+
+bool LogicSolver::eliminate(int cell, uint16_t mask) {
+    uint16_t removed = cand[cell] & mask;
+    if (!removed) return false;
+    cand[cell] &= ~mask;
+    for (uint16_t m = removed; m; m &= m - 1) unlink(cell, __builtin_ctz(m));
+    if (cand[cell] == 0) broken = true;
+    return true;
+}
+
+// Únicos nus e ocultos numa passada.
+bool LogicSolver::singles() {
+    bool progress = false;
+
+    for (int i = 0; i < 81; i++) {
+        if (cells[i] == 0 && __builtin_popcount(cand[i]) == 1) {
+            place(i, __builtin_ctz(cand[i]) + 1);
+            progress = true;
+        }
+    }
+
+    for (auto& house : TABLES.houses) {
+        uint16_t ones = 0, twos = 0, placed = 0;
+        for (int cell : house) {
+            if (cells[cell]) placed |= 1 << (cells[cell] - 1);
+            twos |= ones & cand[cell];
+            ones |= cand[cell];
+        }
+        if ((ones | placed) != ALL_DIGITS) {
+            broken = true;
+            return true;
+        }
+
+        uint16_t hidden = ones & ~twos;
+        while (hidden) {
+            int d = __builtin_ctz(hidden);
+            hidden &= hidden - 1;
+            for (int cell : house) {
+                if (cand[cell] & (1 << d)) {
+                    place(cell, d + 1);
+                    progress = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    return progress;
+}
+
+// Dígito que, na caixa, só aparece na linha: sai do resto da linha.
+bool LogicSolver::pointing() {
+    bool progress = false;
+    for (auto& it : TABLES.intersections) {
+        uint16_t inter = 0, box_rest = 0;
+        for (int cell : it.inter) inter |= cand[cell];
+        for (int cell : it.box_rest) box_rest |= cand[cell];
+
+        uint16_t only = inter & ~box_rest;
+        if (!only) continue;
+        for (int cell : it.line_rest) progress |= eliminate(cell, only);
+    }
+    return progress;
+}
+
+// Dígito que, na linha, só aparece dentro da caixa: sai do resto da caixa.
+bool LogicSolver::box_line() {
+    bool progress = false;
+    for (auto& it : TABLES.intersections) {
+        uint16_t inter = 0, line_rest = 0;
+        for (int cell : it.inter) inter |= cand[cell];
+        for (int cell : it.line_rest) line_rest |= cand[cell];
+
+        uint16_t only = inter & ~line_rest;
+        if (!only) continue;
+        for (int cell : it.box_rest) progress |= eliminate(cell, only);
+    }
+    return progress;
+}
+
+// Pares, trios e quartetos nus e ocultos em cada casa.
+bool LogicSolver::subsets() {
+    for (auto& house : TABLES.houses) {
+        uint16_t empty = 0;
+        uint16_t positions[9] = {};
+        for (int j = 0; j < 9; j++) {
+            int cell = house[j];
+            if (cells[cell]) continue;
+            empty |= 1 << j;
+            for (uint16_t m = cand[cell]; m; m &= m - 1) positions[__builtin_ctz(m)] |= 1 << j;
+        }
+        uint16_t digits = 0;
+        for (int d = 0; d < 9; d++) if (positions[d]) digits |= 1 << d;
+
+        for (int k = 2; k <= 4; k++) {
+            for (uint16_t s : TABLES.subsets[k]) {
+                // Nu: k células cujos candidatos somam k dígitos.
+                if (!(s & ~empty)) {
+                    uint16_t uni = 0;
+                    for (uint16_t m = s; m; m &= m - 1) uni |= cand[house[__builtin_ctz(m)]];
+                    if (__builtin_popcount(uni) == k) {
+                        bool progress = false;
+                        for (uint16_t m = empty & ~s; m; m &= m - 1)
+                            progress |= eliminate(house[__builtin_ctz(m)], uni);
+                        if (progress) return true;
+                    }
+                }
+
+                // Oculto: k dígitos que só cabem em k células.
+                if (!(s & ~digits)) {
+                    uint16_t spots = 0;
+                    for (uint16_t m = s; m; m &= m - 1) spots |= positions[__builtin_ctz(m)];
+                    if (__builtin_popcount(spots) == k) {
+                        bool progress = false;
+                        for (uint16_t m = spots; m; m &= m - 1)
+                            progress |= eliminate(house[__builtin_ctz(m)], ALL_DIGITS & ~s);
+                        if (progress) return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// X-wing, swordfish e jellyfish, com linhas ou colunas como base.
+bool LogicSolver::fish() {
+    for (int d = 0; d < 9; d++) {
+        uint16_t bit = 1 << d;
+        for (int base = 0; base < 2; base++) {
+            const uint8_t (*lines)[9] = TABLES.houses + base * 9;
+            const uint8_t (*covers)[9] = TABLES.houses + (1 - base) * 9;
+
+            uint16_t positions[9], active = 0;
+            for (int l = 0; l < 9; l++) {
+                positions[l] = 0;
+                for (int j = 0; j < 9; j++) if (cand[lines[l][j]] & bit) positions[l] |= 1 << j;
+                if (positions[l]) active |= 1 << l;
+            }
+
+            for (int k = 2; k <= 4; k++) {
+                for (uint16_t s : TABLES.subsets[k]) {
+                    if (s & ~active) continue;
+                    uint16_t uni = 0;
+                    for (uint16_t m = s; m; m &= m - 1) uni |= positions[__builtin_ctz(m)];
+                    if (__builtin_popcount(uni) != k) continue;
+
+                    // A célula j da cobertura c é a célula c da linha-base j.
+                    bool progress = false;
+                    for (uint16_t m = uni; m; m &= m - 1) {
+                        const uint8_t* cover = covers[__builtin_ctz(m)];
+                        for (int j = 0; j < 9; j++)
+                            if (!(s & (1 << j))) progress |= eliminate(cover[j], bit);
+                    }
+                    if (progress) return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// XY-wing e XYZ-wing: um pivô e duas pinças bivalentes que o enxergam; o
+// dígito comum às pinças sai das células que enxergam todas as peças
+// (no XY-wing, só as duas pinças).
+bool LogicSolver::wings() {
+    Bits81 bivalue;
+    for (int i = 0; i < 81; i++)
+        if (__builtin_popcount(cand[i]) == 2) bivalue |= Bits81::cell(i);
+
+    for (int pivot = 0; pivot < 81; pivot++) {
+        int size = __builtin_popcount(cand[pivot]);
+        if (size != 2 && size != 3) continue;
+
+        Bits81 pincers = bivalue & TABLES.peer_bits[pivot];
+        for (Bits81 qs = pincers; qs.any(); qs = qs.minus(Bits81::cell(qs.first()))) {
+            int q = qs.first();
+            for (Bits81 rs = qs.minus(Bits81::cell(q)); rs.any(); rs = rs.minus(Bits81::cell(rs.first()))) {
+                int r = rs.first();
+                uint16_t z = cand[q] & cand[r];
+                if (__builtin_popcount(z) != 1 || cand[q] == cand[r]) continue;
+
+                Bits81 targets = planes[__builtin_ctz(z)] & TABLES.peer_bits[q] & TABLES.peer_bits[r];
+                if (size == 2) {
+                    // XY-wing: pivô {a,b}, pinças {a,z} e {b,z}.
+                    if ((cand[q] | cand[r]) != (cand[pivot] | z) || (cand[pivot] & z)) continue;
+                    targets = targets.minus(Bits81::cell(pivot));
+                } else {
+                    // XYZ-wing: pivô {a,b,z}, pinças {a,z} e {b,z}.
+                    if ((cand[q] | cand[r]) != cand[pivot]) continue;
+                    targets &= TABLES.peer_bits[pivot];
+                }
+
+                bool progress = false;
+                for (; targets.any(); targets = targets.minus(Bits81::cell(targets.first())))
+                    progress |= eliminate(targets.first(), z);
+                if (progress) return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Coloração simples: os pares conjugados de um dígito dividem as células em
+// duas cores, das quais exatamente uma é verdadeira.
+bool LogicSolver::coloring() {
+    for (int d = 0; d < 9; d++) {
+        Bits81 seen;
+        for (Bits81 rest = planes[d]; rest.any(); rest = rest.minus(Bits81::cell(rest.first()))) {
+            int start = rest.first();
+            if (seen.test(start)) continue;
+
+            Bits81 color[2];
+            int stack[81], top = 0;
+            uint8_t parity[81];
+            stack[top++] = start;
+            parity[start] = 0;
+            color[0] = Bits81::cell(start);
+            seen |= Bits81::cell(start);
+
+            while (top > 0) {
+                int cell = stack[--top];
+                for (int k = 0; k < 3; k++) {
+                    int h = TABLES.house_of[cell][k];
+                    if (__builtin_popcount(where[h][d]) != 2) continue;
+                    int other = TABLES.houses[h][__builtin_ctz(where[h][d] & ~(1 << TABLES.index_in[cell][k]))];
+                    if (seen.test(other)) continue;
+                    seen |= Bits81::cell(other);
+                    parity[other] = parity[cell] ^ 1;
+                    color[parity[other]] |= Bits81::cell(other);
+                    stack[top++] = other;
+                }
+            }
+            if (!color[1].any()) continue;
+
+            // Duas células da mesma cor numa casa: essa cor é falsa.
+            for (int c = 0; c < 2; c++) {
+                for (Bits81 m = color[c]; m.any(); m = m.minus(Bits81::cell(m.first()))) {
+                    if (!(TABLES.peer_bits[m.first()] & color[c]).any()) continue;
+                    for (Bits81 f = color[c]; f.any(); f = f.minus(Bits81::cell(f.first())))
+                        eliminate(f.first(), 1 << d);
+                    return true;
+                }
+            }
+
+            // Célula fora da cadeia que enxerga as duas cores.
+            Bits81 sees[2];
+            for (int c = 0; c < 2; c++)
+                for (Bits81 m = color[c]; m.any(); m = m.minus(Bits81::cell(m.first())))
+                    sees[c] |= TABLES.peer_bits[m.first()];
+
+            bool progress = false;
+            Bits81 targets = (planes[d] & sees[0] & sees[1]).minus(color[0] | color[1]);
+            for (; targets.any(); targets = targets.minus(Bits81::cell(targets.first())))
+                progress |= eliminate(targets.first(), 1 << d);
+            if (progress) return true;
+        }
+    }
+    return false;
+}
+
+// Candidatos fracamente ligados a (cell, digit): o mesmo dígito nas células
+// vizinhas e, se a cadeia pode trocar de dígito, os outros da mesma célula.
+void LogicSolver::weak_links(int cell, int digit, bool single_digit, Bits81 out[9]) const {
+    out[digit] |= planes[digit] & TABLES.peer_bits[cell];
+    if (single_digit) return;
+    for (uint16_t m = cand[cell] & ~(1 << digit); m; m &= m - 1)
+        out[__builtin_ctz(m)] |= Bits81::cell(cell);
+}
+
+// Supõe (cell, digit) falso e propaga: falso -> a outra ponta do elo forte é
+// verdadeira; verdadeiro -> tudo que tem elo fraco com ele é falso. Um
+// candidato com elo fraco com o início e com algum verdadeiro é falso nos
+// dois casos; isso cobre todas as cadeias alternadas (AIC) a partir do início,
+// ou só as cadeias X quando `single_digit`.
+bool LogicSolver::implications(int cell, int digit, bool single_digit) {
+    Bits81 is_false[9], is_true[9], frontier[9], seen_by_true[9];
+    is_false[digit] = frontier[digit] = Bits81::cell(cell);
+
+    bool more = true;
+    while (more) {
+        Bits81 now_true[9];
+        for (int d = 0; d < 9; d++) {
+            for (Bits81 m = frontier[d]; m.any(); m = m.minus(Bits81::cell(m.first()))) {
+                int c = m.first();
+                for (int k = 0; k < 3; k++) {
+                    uint16_t spots = where[TABLES.house_of[c][k]][d];
+                    if (__builtin_popcount(spots) != 2) continue;
+                    now_true[d] |= Bits81::cell(TABLES.houses[TABLES.house_of[c][k]][__builtin_ctz(spots & ~(1 << TABLES.index_in[c][k]))]);
+                }
+                if (!single_digit && __builtin_popcount(cand[c]) == 2)
+                    now_true[__builtin_ctz(cand[c] & ~(1 << d))] |= Bits81::cell(c);
+            }
+        }
+
+        Bits81 now_false[9];
+        for (int d = 0; d < 9; d++) {
+            now_true[d] = now_true[d].minus(is_true[d]);
+            is_true[d] |= now_true[d];
+            for (Bits81 m = now_true[d]; m.any(); m = m.minus(Bits81::cell(m.first())))
+                weak_links(m.first(), d, single_digit, now_false);
+        }
+
+        more = false;
+        for (int d = 0; d < 9; d++) {
+            seen_by_true[d] |= now_false[d];
+            frontier[d] = now_false[d].minus(is_false[d]);
+            is_false[d] |= frontier[d];
+            more |= frontier[d].any();
+        }
+    }
+
+    Bits81 start[9];
+    weak_links(cell, digit, single_digit, start);
+
+    bool progress = false;
+    for (int d = 0; d < 9; d++) {
+        for (Bits81 m = start[d] & seen_by_true[d]; m.any(); m = m.minus(Bits81::cell(m.first())))
+            progress |= eliminate(m.first(), 1 << d);
+    }
+    return progress;
+}
+
+bool LogicSolver::chains(bool single_digit) {
+    for (int d = 0; d < 9; d++)
+        for (Bits81 m = planes[d]; m.any(); m = m.minus(Bits81::cell(m.first())))
+            if (implications(m.first(), d, single_digit)) return true;
+    return false;
+}
+
+Grade LogicSolver::solve() {
+    Grade hardest = GRADE_SINGLES;
+
+    while (!broken && unsolved > 0) {
+        if (singles()) continue;
+
+        Grade used;
+        if (pointing()) used = GRADE_POINTING;
+        else if (box_line()) used = GRADE_BOX_LINE;
+        else if (subsets()) used = GRADE_SUBSETS;
+        else if (fish()) used = GRADE_FISH;
+        else if (wings()) used = GRADE_WINGS;
+        else if (coloring() || chains(true)) used = GRADE_CHAINS;
+        else if (chains(false)) used = GRADE_AIC;
+        else return GRADE_GUESS;
+
+        hardest = std::max(hardest, used);
+    }
+
+    return broken ? GRADE_GUESS : hardest;
+}
+
+Grid LogicSolver::grid() const {
+    Grid grid;
+    for (int i = 0; i < 81; i++) grid[i] = cells[i];
+    return grid;
+}
+
+Grade grade(const Grid& puzzle) {
+    LogicSolver solver(puzzle);
+    return solver.solve();
+}
@@ -0,0 +1,86 @@
+#ifndef SUDOKU_GRADER_H
+#define SUDOKU_GRADER_H
+
+#include <cstdint>
+
+#include "BitBoard.h"
+#include "sudoku.h"
+
+// Tabuleiros gerados seguidos sem a técnica pedida antes de desistir: alguns
+// níveis nunca produzem certas técnicas (peixes com poucas células em branco).
+#define GRADE_TRIES 1000
+
+// Técnica mais difícil que um jogador precisa para resolver o tabuleiro, em
+// ordem crescente. GRADE_GUESS: as técnicas não bastam (ou não há solução).
+enum Grade {
+    GRADE_SINGLES,
+    GRADE_POINTING,
+    GRADE_BOX_LINE,
+    GRADE_SUBSETS,
+    GRADE_FISH,
+    GRADE_WINGS,
+    GRADE_CHAINS,
+    GRADE_AIC,
+    GRADE_GUESS,
+    NUM_GRADES
+};
+
+const char* grade_name(int grade);
+
+// Resolvedor lógico sobre máscaras de candidatos: bit (v - 1) de cand[i]
+// indica que v ainda cabe na célula i, e células resolvidas têm máscara 0.
+// Cada técnica devolve true quando eliminou algo, e a resolução sempre volta
+// para a mais simples depois de um avanço.
+//
+// Grafo de ligações para asas e cadeias: where[h][d] guarda as posições do
+// dígito d na casa h e planes[d] as células com d; um elo forte é uma casa
+// com exatamente duas posições (ou uma célula com dois candidatos). Ambos são
+// atualizados só nas casas da célula afetada a cada eliminação.
+class LogicSolver {
+private:
+    uint8_t cells[81];
+    uint16_t cand[81];
+    uint16_t where[27][9];
+    Bits81 planes[9];
+    int unsolved;
+    bool broken;
+
+    void unlink(int cell, int digit);
+
+    bool place(int cell, int digit);
+
+    bool eliminate(int cell, uint16_t mask);
+
+    void weak_links(int cell, int digit, bool single_digit, Bits81 out[9]) const;
+
+    bool implications(int cell, int digit, bool single_digit);
+
+    bool singles();
+
+    bool pointing();
+
+    bool box_line();
+
+    bool subsets();
+
+    bool fish();
+
+    bool wings();
+
+    bool coloring();
+
+    bool chains(bool single_digit);
+public:
+
+    explicit LogicSolver(const Grid& puzzle);
+
+    Grade solve();
+
+    bool solved() const { return unsolved == 0 && !broken; }
+
+    Grid grid() const;
+};
+
+Grade grade(const Grid& puzzle);
+
+#endif //SUDOKU_GRADER_H
@@ -0,0 +1,284 @@
+#include "Killer.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "Constraints.h"
+
+// Vizinhos ortogonais de uma célula, para as gaiolas serem conexas.
+static int neighbors(int cell, int out[4]) {
+    int l = cell / 9, c = cell % 9, n = 0;
+    if (l > 0) out[n++] = cell - 9;
+    if (l < 8) out[n++] = cell + 9;
+    if (c > 0) out[n++] = cell - 1;
+    if (c < 8) out[n++] = cell + 1;
+    return n;
+}
+
+void Killer::clear() {
+    cages.clear();
+    sums.clear();
+    std::fill(cage_of, cage_of + 81, NO_CAGE);
+}
+
+void Killer::rebuild(const Grid& solution, int label[81], Grid& givens) {
+    clear();
+    givens = {};
+
+    bool seen[81] = {};
+    for (int start = 0; start < 81; start++) {
+        if (seen[start] || label[start] == -1) continue;
+
+        int members[81], size = 0;
+        members[size++] = start;
+        seen[start] = true;
+        for (int k = 0; k < size; k++) {
+            int nb[4];
+            int n = neighbors(members[k], nb);
+            for (int j = 0; j < n; j++) {
+                if (seen[nb[j]] || label[nb[j]] != label[start]) continue;
+                seen[nb[j]] = true;
+                members[size++] = nb[j];
+            }
+        }
+
+        if (size == 1) {
+            label[start] = -1;
+            continue;
+        }
+
+        Cage cage = {Bits81(), (uint8_t) size, 0, (uint8_t) *std::min_element(members, members + size)};
+        for (int k = 0; k < size; k++) {
+            cage.cells |= Bits81::cell(members[k]);
+            cage.sum += solution[members[k]];
+            cage_of[members[k]] = cages.size();
+        }
+        cages.push_back(cage);
+    }
+
+    for (int i = 0; i < 81; i++)
+        if (label[i] == -1) givens[i] = solution[i];
+
+    sums = cages;
+    const ConstraintTable& table = rules();
+    for (int h = 0; h < table.num_houses; h++) {
+        Cage rest = {table.house_mask[h], 9, 45, 0};
+        for (auto& cage : cages) {
+            if (cage.cells.minus(rest.cells).any()) continue;
+            rest.cells = rest.cells.minus(cage.cells);
+            rest.size -= cage.size;
+            rest.sum -= cage.sum;
+        }
+        if (rest.size > 0 && rest.size < 9) sums.push_back(rest);
+    }
+}
+
+uint16_t Killer::open_digits(const Cage& cage, const uint8_t cells[81]) const {
+    uint16_t used = 0;
+    int placed = 0, sum = 0;
+    for (Bits81 rest = cage.cells; rest.any();) {
+        int i = rest.first();
+        rest = rest.minus(Bits81::cell(i));
+        if (cells[i] == 0) continue;
+
+        uint16_t bit = 1 << (cells[i] - 1);
+        if (used & bit) return 0;
+        used |= bit;
+        placed++;
+        sum += cells[i];
+    }
+
+    int left = cage.sum - sum;
+    if (left < 0 || left > 45) return 0;
+    return CAGE_TABLE.digits[cage.size - placed][left] & ~used;
+}
+
+bool Killer::allows(const uint8_t cells[81], int cell, int val) const {
+    if (cage_of[cell] == NO_CAGE) return true;
+    return open_digits(cages[cage_of[cell]], cells) & (1 << (val - 1));
+}
+
+void Killer::restrict(const uint8_t cells[81], Candidates& out) const {
+    for (auto& cage : cages) {
+        uint16_t open = open_digits(cage, cells);
+        for (Bits81 rest = cage.cells; rest.any();) {
+            int i = rest.first();
+            rest = rest.minus(Bits81::cell(i));
+            out.mask[i] &= open;
+            out.count[i] = __builtin_popcount(out.mask[i]);
+        }
+    }
+
+    int best_count = 10;
+    out.best = -1;
+    for (int i = 0; i < 81; i++) {
+        if (cells[i] == 0 && out.count[i] < best_count) {
+            best_count = out.count[i];
+            out.best = i;
+        }
+    }
+}
+
+// Em cada gaiola, os dígitos que não estão em nenhuma combinação viável do
+// par (vazias, falta) saem das células vazias. Viável: sem dígito já usado na
+// gaiola e com algum candidato de cada célula vazia.
+bool Killer::prune(BitBoard& board) const {
+    bool changed = false;
+    for (auto& cage : sums) {
+        Bits81 done = cage.cells & board.solved;
+        Bits81 open = cage.cells.minus(board.solved);
+
+        uint16_t used = 0;
+        int sum = 0;
+        for (int d = 0; d < 9; d++) {
+            int n = (board.planes[d] & done).count();
+            if (n > 1) return false;
+            if (n == 1) {
+                used |= 1 << d;
+                sum += d + 1;
+            }
+        }
+
+        int size = open.count();
+        int left = cage.sum - sum;
+        if (left < 0 || left > 45) return false;
+        if (size == 0) {
+            if (left != 0) return false;
+            continue;
+        }
+
+        uint16_t cand[9];
+        int n = 0;
+        for (Bits81 rest = open; rest.any();) {
+            int i = rest.first();
+            rest = rest.minus(Bits81::cell(i));
+            cand[n] = 0;
+            for (int d = 0; d < 9; d++)
+                if (board.planes[d].test(i)) cand[n] |= 1 << d;
+            n++;
+        }
+
+        uint16_t allowed = 0;
+        int key = size * 46 + left;
+        for (int k = CAGE_TABLE.start[key]; k < CAGE_TABLE.start[key + 1]; k++) {
+            uint16_t combo = CAGE_TABLE.combos[k];
+            if (combo & used) continue;
+
+            bool fits = true;
+            for (int j = 0; j < n && fits; j++) fits = cand[j] & combo;
+            if (fits) allowed |= combo;
+        }
+        if (allowed == 0) return false;
+
+        for (int d = 0; d < 9; d++) {
+            if ((allowed & (1 << d)) || !(board.planes[d] & open).any()) continue;
+            board.planes[d] = board.planes[d].minus(open);
+            changed = true;
+        }
+    }
+
+    if (changed) return propagate(board);
+    return true;
+}
+
+bool Killer::propagate(BitBoard& board) const {
+    return board.propagate() && prune(board);
+}
+
+// Como o fill_bits do Board: `nodes` negativo ao voltar quando o limite, o
+// prazo ou o cancelamento interromperam.
+void Killer::search(BitBoard board, int limit, int& count, Grid found[2], long& nodes, Clock::time_point deadline,
+                    const CancelToken* cancel) const {
+    if (--nodes < 0) return;
+    if ((nodes & 0xFF) == 0 && (Clock::now() >= deadline || (cancel && cancel->cancelled()))) {
+        nodes = -1;
+        return;
+    }
+
+    if (!propagate(board)) return;
+
+    if (board.solved.count() == 81) {
+        if (count < 2) found[count] = board.to_grid();
+        count++;
+        return;
+    }
+
+    int cell = board.branch_cell();
+    for (int d = 0; d < 9; d++) {
+        if (!board.planes[d].test(cell)) continue;
+
+        BitBoard next = board;
+        next.place(cell, d);
+        search(next, limit, count, found, nodes, deadline, cancel);
+        if (count >= limit || nodes < 0) return;
+    }
+}
+
+int Killer::count_solutions(const Grid& givens, int limit, Grid* solution, Grid* other, long max_nodes,
+                            Clock::time_point deadline, const CancelToken* cancel) const {
+    BitBoard board;
+    if (!board.from_grid(givens)) return 0;
+
+    Grid found[2];
+    int count = 0;
+    long nodes = max_nodes;
+    search(board, limit, count, found, nodes, deadline, cancel);
+    if (nodes < 0 && count < limit) return -1;
+    if (solution != nullptr && count > 0) *solution = found[0];
+    if (other != nullptr && count > 1) *other = found[1];
+    return count;
+}
+
+bool Killer::generate(const Grid& solution, Grid& givens, Clock::time_point deadline, const CancelToken* cancel) {
+    int label[81];
+    std::fill(label, label + 81, -1);
+
+    int order[81];
+    for (int i = 0; i < 81; i++) order[i] = i;
+    for (int k = 80; k > 0; k--) std::swap(order[k], order[rand() % (k + 1)]);
+
+    // Cada gaiola cresce a partir de uma célula livre por vizinhos livres
+    // cujo dígito ainda não está nela.
+    int next = 0;
+    for (int start : order) {
+        if (label[start] != -1) continue;
+
+        int members[KILLER_MAX_CAGE], size = 0;
+        int target = 2 + rand() % (KILLER_MAX_CAGE - 1);
+        uint16_t digits = 1 << (solution[start] - 1);
+        label[start] = next;
+        members[size++] = start;
+
+        while (size < target) {
+            int options[4 * KILLER_MAX_CAGE], n = 0;
+            for (int k = 0; k < size; k++) {
+                int nb[4];
+                int m = neighbors(members[k], nb);
+                for (int j = 0; j < m; j++)
+                    if (label[nb[j]] == -1 && !(digits & (1 << (solution[nb[j]] - 1)))) options[n++] = nb[j];
+            }
+            if (n == 0) break;
+
+            int pick = options[rand() % n];
+            label[pick] = next;
+            digits |= 1 << (solution[pick] - 1);
+            members[size++] = pick;
+        }
+        next++;
+    }
+    rebuild(solution, label, givens);
+
+    // Enquanto houver duas soluções, uma célula em que elas diferem vira
+    // pista e sua gaiola se parte no que sobrar; cada passo elimina uma delas.
+    Grid first, second;
+    while (true) {
+        int sols = count_solutions(givens, 2, &first, &second, KILLER_NODES, deadline, cancel);
+        if (sols != 2) return sols == 1;
+
+        int diff[81], n = 0;
+        for (int i = 0; i < 81; i++)
+            if (first[i] != second[i]) diff[n++] = i;
+        label[diff[rand() % n]] = -1;
+        rebuild(solution, label, givens);
+    }
+}
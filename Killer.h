@@ -0,0 +1,120 @@
+#ifndef SUDOKU_KILLER_H
+#define SUDOKU_KILLER_H
+
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include "BitBoard.h"
+#include "Board.h"
+#include "Cancel.h"
+#include "Candidates.h"
+#include "sudoku.h"
+
+// Tamanho máximo das gaiolas sorteadas pelo gerador.
+#define KILLER_MAX_CAGE 5
+// Nós de cada teste de unicidade do gerador; estourar descarta a solução
+// sorteada, como os reinícios do Board::fill.
+#define KILLER_NODES 200
+#define NO_CAGE 0xFF
+
+// Para cada par (tamanho, soma), as combinações de dígitos distintos com esse
+// tamanho e essa soma, e a união delas; calculado pelo compilador. As
+// combinações do par ficam em combos[start[k] .. start[k + 1]), com
+// k = tamanho * 46 + soma. digits[0][0] é 0, e pares impossíveis também.
+struct CageTable {
+    uint16_t digits[10][46];
+    uint16_t combos[512];
+    uint16_t start[10 * 46 + 1];
+
+    constexpr CageTable() : digits(), combos(), start() {
+        int key[512] = {};
+        for (int mask = 0; mask < 512; mask++) {
+            int size = 0, sum = 0;
+            for (int d = 0; d < 9; d++) {
+                if (mask & (1 << d)) {
+                    size++;
+                    sum += d + 1;
+                }
+            }
+            digits[size][sum] |= mask;
+            key[mask] = size * 46 + sum;
+            start[key[mask] + 1]++;
+        }
+        for (int k = 0; k < 10 * 46; k++) start[k + 1] += start[k];
+
+        uint16_t filled[10 * 46] = {};
+        for (int mask = 0; mask < 512; mask++)
+            combos[start[key[mask]] + filled[key[mask]]++] = mask;
+    }
+};
+
+inline constexpr CageTable CAGE_TABLE;
+
+// Gaiola do killer: células (sem dígito repetido) e a soma delas.
+struct Cage {
+    Bits81 cells;
+    uint8_t size;
+    uint8_t sum;
+    // Célula de menor índice, onde a soma é desenhada.
+    uint8_t first;
+};
+
+// Jogo killer: as gaiolas valem junto com as regras em uso. A poda é só
+// consulta e AND: numa gaiola com `n` células vazias faltando `s`, cada
+// célula vazia fica com CAGE_TABLE.digits[n][s] menos os dígitos já usados.
+// Na busca, só contam as combinações do par que deixam algum candidato em
+// cada célula vazia, e cada casa soma 45.
+class Killer {
+private:
+    std::vector<Cage> cages;
+    uint8_t cage_of[81];
+    // Gaiolas e, para cada casa, as células dela fora das gaiolas contidas
+    // nela, com o que falta para 45; só a busca usa.
+    std::vector<Cage> sums;
+
+    // Recria as gaiolas a partir dos rótulos, uma por componente conexa;
+    // componentes de uma célula só viram pistas em `givens` (e rótulo -1).
+    void rebuild(const Grid& solution, int label[81], Grid& givens);
+
+    // Dígitos que ainda cabem nas células vazias da gaiola, dadas as células
+    // preenchidas; 0 se a gaiola já não fecha.
+    uint16_t open_digits(const Cage& cage, const uint8_t cells[81]) const;
+
+    bool prune(BitBoard& board) const;
+
+    void search(BitBoard board, int limit, int& count, Grid found[2], long& nodes, Clock::time_point deadline,
+                const CancelToken* cancel) const;
+public:
+
+    Killer() { clear(); }
+
+    void clear();
+
+    bool empty() const { return cages.empty(); }
+
+    const std::vector<Cage>& get_cages() const { return cages; }
+
+    int cage_at(int cell) const { return cage_of[cell] == NO_CAGE ? -1 : cage_of[cell]; }
+
+    // Gaiolas aleatórias sobre a solução, divididas até o jogo ter solução
+    // única; as células que precisaram virar pistas vêm em `givens`. Falso se
+    // o prazo, o cancelamento ou KILLER_NODES num teste interromperam.
+    bool generate(const Grid& solution, Grid& givens, Clock::time_point deadline = Clock::time_point::max(),
+                  const CancelToken* cancel = nullptr);
+
+    bool allows(const uint8_t cells[81], int cell, int val) const;
+
+    // Tira dos candidatos o que as gaiolas proíbem.
+    void restrict(const uint8_t cells[81], Candidates& out) const;
+
+    // Propagação das regras em uso e das gaiolas até parar; falso em contradição.
+    bool propagate(BitBoard& board) const;
+
+    // -1 se a busca parou antes de saber: `max_nodes` nós, prazo ou cancelamento.
+    int count_solutions(const Grid& givens, int limit, Grid* solution = nullptr, Grid* other = nullptr,
+                        long max_nodes = LONG_MAX, Clock::time_point deadline = Clock::time_point::max(),
+                        const CancelToken* cancel = nullptr) const;
+};
+
+#endif //SUDOKU_KILLER_H
@@ -0,0 +1,57 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        ::close(fd);
+        return false;
+    }
+    // mmap não aceita tamanho zero.
+    if (st.st_size == 0) {
+        ::close(fd);
+        opened = true;
+        return true;
+    }
+
+    void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) return false;
+
+    data = ptr;
+    length = st.st_size;
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data != nullptr) munmap(data, length);
+    data = nullptr;
+    length = 0;
+    opened = false;
+}
+
+bool MappedFile::is_open() {
+    return opened;
+}
+
+const uint8_t* MappedFile::bytes() {
+    return static_cast<const uint8_t*>(data);
+}
+
+size_t MappedFile::size() {
+    return length;
+}
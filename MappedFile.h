@@ -0,0 +1,37 @@
+#ifndef SUDOKU_MAPPEDFILE_H
+#define SUDOKU_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Arquivo mapeado somente para leitura; o conteúdo é acessado direto da
+// memória, sem cópia nem interpretação no carregamento. Um arquivo vazio abre
+// sem mapeamento, com size() == 0.
+class MappedFile {
+private:
+    void* data = nullptr;
+    size_t length = 0;
+    bool opened = false;
+public:
+
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    bool open(const std::string& path);
+
+    void close();
+
+    bool is_open();
+
+    const uint8_t* bytes();
+
+    size_t size();
+};
+
+#endif //SUDOKU_MAPPEDFILE_H
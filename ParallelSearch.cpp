@@ -0,0 +1,45 @@
+#include "ParallelSearch.h"
+
+#include <algorithm>
+#include <vector>
+
+#define SPLIT_DEPTH 4
+#define TASKS_PER_THREAD 8
+
+int count_solutions_parallel(const BitBoard& board, int limit, ThreadPool& pool, Grid* solution) {
+    std::atomic<int> count{0};
+
+    // Expande a fronteira em largura até haver tarefas para todos os workers.
+    std::vector<BitBoard> frontier{board};
+    size_t wanted = pool.size() * TASKS_PER_THREAD;
+    for (int depth = 0; depth < SPLIT_DEPTH && frontier.size() < wanted; depth++) {
+        std::vector<BitBoard> next;
+        for (BitBoard& node : frontier) {
+            if (!node.propagate()) continue;
+            if (node.solved.count() == 81) {
+                if (count.fetch_add(1) == 0 && solution != nullptr) *solution = node.to_grid();
+                continue;
+            }
+
+            int cell = node.branch_cell();
+            for (int d = 0; d < 9; d++) {
+                if (!node.planes[d].test(cell)) continue;
+                next.push_back(node);
+                next.back().place(cell, d);
+            }
+        }
+        frontier.swap(next);
+        if (count >= limit) return limit;
+    }
+
+    TaskGroup group(pool);
+    for (const BitBoard& node : frontier) {
+        group.run([&, node] {
+            BitBoard copy = node;
+            copy.search(limit, count, solution);
+        });
+    }
+    group.wait();
+
+    return std::min<int>(count, limit);
+}
@@ -0,0 +1,12 @@
+#ifndef SUDOKU_PARALLELSEARCH_H
+#define SUDOKU_PARALLELSEARCH_H
+
+#include "BitBoard.h"
+#include "ThreadPool.h"
+
+// Conta soluções (até `limit`) dividindo os primeiros níveis da árvore de
+// busca em tarefas no pool. Todas compartilham um contador atômico e param
+// assim que ele chega a `limit`.
+int count_solutions_parallel(const BitBoard& board, int limit, ThreadPool& pool, Grid* solution = nullptr);
+
+#endif //SUDOKU_PARALLELSEARCH_H
@@ -0,0 +1,97 @@
+#include "Portfolio.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <random>
+
+#include "BitBoard.h"
+#include "Board.h"
+#include "Cancel.h"
+#include "ExactCover.h"
+
+#define RANDOM_STRATEGIES 2
+
+// Busca MRV do BitBoard. Com `rng`, os dígitos do tabuleiro passam por uma
+// permutação aleatória antes da busca, o que embaralha a ordem dos valores em
+// cada ramificação; a solução é traduzida de volta.
+static int bit_search(const Grid& puzzle, int limit, Grid& solution, std::mt19937* rng, const CancelToken& cancel) {
+    uint8_t to[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, from[10];
+    if (rng != nullptr) std::shuffle(to + 1, to + 10, *rng);
+    for (int d = 0; d < 10; d++) from[to[d]] = d;
+
+    Grid mapped;
+    for (int i = 0; i < 81; i++) mapped[i] = puzzle[i] <= 9 ? to[puzzle[i]] : puzzle[i];
+
+    BitBoard board;
+    if (!board.from_grid(mapped)) return 0;
+
+    Grid found = {};
+    int count = board.count_solutions(limit, &found, nullptr, &cancel);
+    for (int i = 0; i < 81; i++) solution[i] = from[found[i]];
+    return count;
+}
+
+PortfolioResult solve_portfolio(const Grid& puzzle, ThreadPool& pool, int limit) {
+    std::mutex mutex;
+    bool finished = false;
+    PortfolioResult result;
+    CancelToken cancel;
+
+    // Cada estratégia só publica se terminou sem ser cancelada; a primeira
+    // cancela as outras, e as que ainda estão na fila saem logo ao começar.
+    auto publish = [&](int count, const Grid& solution, const char* name) {
+        if (cancel.cancelled()) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (finished) return;
+        finished = true;
+        result.solutions = count;
+        result.solution = solution;
+        result.strategy = name;
+        cancel.cancel();
+    };
+
+    TaskGroup group(pool);
+
+    // A ordem de Board::unique_rec só conta até 2; com limite maior ela fica
+    // de fora.
+    if (limit <= 2) {
+        group.run([&] {
+            Board board;
+            board.set_grid(puzzle);
+            if (!board.is_valid()) {
+                publish(0, Grid(), "board");
+                return;
+            }
+            int sols = 0;
+            Grid solution = {};
+            board.unique_rec(sols, &cancel, nullptr, &solution);
+            publish(std::min(sols, limit), solution, "board");
+        });
+    }
+
+    group.run([&] {
+        Grid solution = {};
+        int count = bit_search(puzzle, limit, solution, nullptr, cancel);
+        publish(count, solution, "mrv");
+    });
+
+    for (int k = 0; k < RANDOM_STRATEGIES; k++) {
+        group.run([&, k] {
+            std::mt19937 rng(std::random_device{}() + k);
+            Grid solution = {};
+            int count = bit_search(puzzle, limit, solution, &rng, cancel);
+            publish(count, solution, "random");
+        });
+    }
+
+    group.run([&] {
+        std::unique_ptr<ExactCover> cover(new ExactCover(puzzle));
+        Grid solution = {};
+        int count = cover->count_solutions(limit, &solution, &cancel);
+        publish(count, solution, "exact-cover");
+    });
+
+    group.wait();
+    return result;
+}
@@ -0,0 +1,21 @@
+#ifndef SUDOKU_PORTFOLIO_H
+#define SUDOKU_PORTFOLIO_H
+
+#include "ThreadPool.h"
+#include "sudoku.h"
+
+// Resultado da primeira estratégia que terminou: número de soluções
+// (até o limite pedido), a primeira solução e o nome da estratégia.
+struct PortfolioResult {
+    int solutions = 0;
+    Grid solution = {};
+    const char* strategy = nullptr;
+};
+
+// Roda várias estratégias de busca ao mesmo tempo nas threads de `pool` (a
+// ordem de Board::unique_rec, só com limite até 2; MRV em bitboard, ordens de
+// valores aleatórias e cobertura exata), fica com a primeira resposta
+// conclusiva e cancela as outras.
+PortfolioResult solve_portfolio(const Grid& puzzle, ThreadPool& pool, int limit = 2);
+
+#endif //SUDOKU_PORTFOLIO_H
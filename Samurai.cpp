@@ -0,0 +1,405 @@
+#include "Samurai.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "Unavoidable.h"
+
+// Canto superior esquerdo de cada grade no quadro.
+static const int ORIGINS[SAMURAI_GRIDS][2] = {{0, 0}, {0, 12}, {6, 6}, {12, 0}, {12, 12}};
+
+SamuraiLayout::SamuraiLayout() {
+    int grids_at[SAMURAI_SIDE][SAMURAI_SIDE] = {};
+    for (auto& origin : ORIGINS)
+        for (int l = 0; l < 9; l++)
+            for (int c = 0; c < 9; c++)
+                grids_at[origin[0] + l][origin[1] + c]++;
+
+    int n = 0;
+    for (int l = 0; l < SAMURAI_SIDE; l++) {
+        for (int c = 0; c < SAMURAI_SIDE; c++) {
+            index[l][c] = grids_at[l][c] > 0 ? n : -1;
+            if (grids_at[l][c] == 0) continue;
+            row[n] = l;
+            col[n] = c;
+            n++;
+        }
+    }
+
+    // As origens são múltiplas de 3, então as caixas de todas as grades caem
+    // na mesma malha 7x7; cada caixa da malha vira uma casa só.
+    bool box_seen[7][7] = {};
+    int h = 0;
+    for (int g = 0; g < SAMURAI_GRIDS; g++) {
+        int top = ORIGINS[g][0], left = ORIGINS[g][1];
+        for (int k = 0; k < 81; k++) {
+            int l = top + k / 9, c = left + k % 9;
+            grid_cells[g][k] = index[l][c];
+            if (grids_at[l][c] > 1) shared[g] |= SamuraiSet::cell(index[l][c]);
+        }
+
+        for (int k = 0; k < 9; k++, h += 2) {
+            for (int j = 0; j < 9; j++) {
+                houses[h][j] = index[top + k][left + j];
+                houses[h + 1][j] = index[top + j][left + k];
+            }
+        }
+
+        for (int b = 0; b < 9; b++) {
+            int bl = top / 3 + b / 3, bc = left / 3 + b % 3;
+            if (box_seen[bl][bc]) continue;
+            box_seen[bl][bc] = true;
+            for (int j = 0; j < 9; j++) houses[h][j] = index[bl * 3 + j / 3][bc * 3 + j % 3];
+            h++;
+        }
+    }
+
+    for (int k = 0; k < SAMURAI_HOUSES; k++) {
+        for (int cell : houses[k]) house_mask[k] |= SamuraiSet::cell(cell);
+        all |= house_mask[k];
+    }
+
+    for (int i = 0; i < SAMURAI_CELLS; i++) {
+        SamuraiSet p;
+        for (int k = 0; k < SAMURAI_HOUSES; k++)
+            if (house_mask[k].test(i)) p |= house_mask[k];
+        peer_mask[i] = p.minus(SamuraiSet::cell(i));
+    }
+}
+
+const SamuraiLayout SAMURAI;
+
+SamuraiBitBoard::SamuraiBitBoard() {
+    for (auto& plane : planes) plane = SAMURAI.all;
+}
+
+bool SamuraiBitBoard::from_grid(const SamuraiGrid& grid) {
+    *this = SamuraiBitBoard();
+    for (int i = 0; i < SAMURAI_CELLS; i++) {
+        if (grid[i] == 0) continue;
+        if (grid[i] > 9 || !planes[grid[i] - 1].test(i)) return false;
+        place(i, grid[i] - 1);
+    }
+    return true;
+}
+
+SamuraiGrid SamuraiBitBoard::to_grid() const {
+    SamuraiGrid grid = {};
+    for (int d = 0; d < 9; d++) {
+        SamuraiSet cells = planes[d] & solved;
+        while (cells.any()) {
+            int i = cells.first();
+            grid[i] = d + 1;
+            cells = cells.minus(SamuraiSet::cell(i));
+        }
+    }
+    return grid;
+}
+
+void SamuraiBitBoard::place(int cell, int digit) {
+    SamuraiSet bit = SamuraiSet::cell(cell);
+    for (auto& plane : planes) plane = plane.minus(bit);
+    planes[digit] = planes[digit].minus(SAMURAI.peer_mask[cell]) | bit;
+    solved |= bit;
+}
+
+// Únicos nus pela contagem bit a bit dos planos e únicos ocultos nas 131
+// casas, como no BitBoard; falso em contradição.
+bool SamuraiBitBoard::propagate() {
+    while (true) {
+        SamuraiSet unsolved = SAMURAI.all.minus(solved);
+        if (!unsolved.any()) return true;
+
+        SamuraiSet ones, twos;
+        for (auto& plane : planes) {
+            twos |= ones & plane;
+            ones |= plane;
+        }
+        if (unsolved.minus(ones).any()) return false;
+
+        SamuraiSet naked = ones.minus(twos) & unsolved;
+        if (naked.any()) {
+            while (naked.any()) {
+                int i = naked.first();
+                naked = naked.minus(SamuraiSet::cell(i));
+
+                int d = 0;
+                while (d < 9 && !planes[d].test(i)) d++;
+                if (d == 9) return false;
+                place(i, d);
+            }
+            continue;
+        }
+
+        bool progress = false;
+        for (int d = 0; d < 9; d++) {
+            for (int h = 0; h < SAMURAI_HOUSES; h++) {
+                SamuraiSet spots = planes[d] & SAMURAI.house_mask[h];
+                if ((spots & solved).any()) continue;
+
+                int n = spots.count();
+                if (n == 0) return false;
+                if (n == 1) {
+                    place(spots.first(), d);
+                    progress = true;
+                }
+            }
+        }
+        if (!progress) return true;
+    }
+}
+
+// Prefere uma célula com exatamente dois candidatos; sem nenhuma, procura a
+// de menor contagem.
+int SamuraiBitBoard::branch_cell() const {
+    SamuraiSet unsolved = SAMURAI.all.minus(solved);
+
+    SamuraiSet ones, twos, threes;
+    for (auto& plane : planes) {
+        threes |= twos & plane;
+        twos |= ones & plane;
+        ones |= plane;
+    }
+    SamuraiSet pairs = twos.minus(threes) & unsolved;
+    if (pairs.any()) return pairs.first();
+
+    int best = 10;
+    int cell = unsolved.first();
+    for (SamuraiSet rest = unsolved; rest.any();) {
+        int i = rest.first();
+        rest = rest.minus(SamuraiSet::cell(i));
+        int n = 0;
+        for (auto& plane : planes) n += plane.test(i);
+        if (n < best) {
+            best = n;
+            cell = i;
+        }
+    }
+    return cell;
+}
+
+static void search(SamuraiBitBoard board, int limit, int& count, SamuraiGrid* solution,
+                   const CancelToken* cancel, SearchStats* stats) {
+    if (cancel && cancel->cancelled()) return;
+    if (stats) stats->nodes++;
+
+    if (!board.propagate()) {
+        if (stats) stats->backtracks++;
+        return;
+    }
+
+    if (!SAMURAI.all.minus(board.solved).any()) {
+        if (count == 0 && solution != nullptr) *solution = board.to_grid();
+        count++;
+        return;
+    }
+
+    int cell = board.branch_cell();
+    for (int d = 0; d < 9; d++) {
+        if (!board.planes[d].test(cell)) continue;
+
+        SamuraiBitBoard next = board;
+        next.place(cell, d);
+        search(next, limit, count, solution, cancel, stats);
+        if (count >= limit) return;
+    }
+}
+
+int SamuraiBitBoard::count_solutions(int limit, SamuraiGrid* solution, const CancelToken* cancel) const {
+    int count = 0;
+    search(*this, limit, count, solution, cancel, nullptr);
+    return count;
+}
+
+// Como o fill_bits do Board: ordem aleatória dos dígitos a cada ramificação
+// e `nodes` negativo quando o limite ou o prazo acabaram.
+static bool fill_bits(SamuraiBitBoard& board, long& nodes, Clock::time_point deadline, const CancelToken* cancel) {
+    if (--nodes < 0) return false;
+    if ((nodes & 0xFF) == 0 && (Clock::now() >= deadline || (cancel && cancel->cancelled()))) {
+        nodes = -1;
+        return false;
+    }
+
+    if (!board.propagate()) return false;
+    if (!SAMURAI.all.minus(board.solved).any()) return true;
+
+    int cell = board.branch_cell();
+    int order[9] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    for (int k = 8; k > 0; k--)
+        std::swap(order[k], order[rand() % (k + 1)]);
+
+    for (int d : order) {
+        if (!board.planes[d].test(cell)) continue;
+
+        SamuraiBitBoard next = board;
+        next.place(cell, d);
+        if (fill_bits(next, nodes, deadline, cancel)) {
+            board = next;
+            return true;
+        }
+        if (nodes < 0) return false;
+    }
+
+    return false;
+}
+
+bool Samurai::fill_rec(long& nodes, Clock::time_point deadline, const CancelToken* cancel) {
+    SamuraiBitBoard board;
+    if (!board.from_grid(tiles)) return false;
+    if (!fill_bits(board, nodes, deadline, cancel)) return false;
+
+    tiles = board.to_grid();
+    return true;
+}
+
+bool Samurai::fill(long max_nodes, Clock::time_point deadline, const CancelToken* cancel) {
+    SamuraiGrid start = tiles;
+
+    for (long run = 1; max_nodes > 0 && Clock::now() < deadline && !(cancel && cancel->cancelled()); run++) {
+        long nodes = std::min(max_nodes, RESTART_NODES * luby(run));
+        max_nodes -= nodes;
+
+        if (fill_rec(nodes, deadline, cancel)) return true;
+        tiles = start;
+
+        if (nodes >= 0) return false;
+    }
+
+    return false;
+}
+
+bool Samurai::is_unique_solvable(const CancelToken* cancel) {
+    SamuraiBitBoard board;
+    if (!board.from_grid(tiles)) return false;
+
+    SearchStats stats;
+    int count = 0;
+    search(board, 2, count, nullptr, cancel, &stats);
+    if (cancel && cancel->cancelled()) return false;
+
+    effort = stats;
+    return count == 1;
+}
+
+// Conjuntos inevitáveis de cada grade que não tocam as caixas compartilhadas:
+// trocá-los só mexe em casas dessa grade, então continuam inevitáveis no
+// samurai inteiro.
+static std::vector<SamuraiSet> samurai_unavoidable(const SamuraiGrid& solution) {
+    std::vector<SamuraiSet> sets;
+    for (int g = 0; g < SAMURAI_GRIDS; g++) {
+        Grid sub;
+        for (int k = 0; k < 81; k++) sub[k] = solution[SAMURAI.grid_cells[g][k]];
+
+        Unavoidable ua;
+        ua.build(sub);
+        for (const Bits81& mask : ua.masks()) {
+            SamuraiSet set;
+            for (Bits81 rest = mask; rest.any();) {
+                int k = rest.first();
+                rest = rest.minus(Bits81::cell(k));
+                set |= SamuraiSet::cell(SAMURAI.grid_cells[g][k]);
+            }
+            if (!(set & SAMURAI.shared[g]).any()) sets.push_back(set);
+        }
+    }
+    return sets;
+}
+
+// O laço do Board::remove sobre as 369 células: sorteia uma pista, recusa sem
+// busca o que esvazia um conjunto inevitável e só aceita o que mantém a
+// solução única.
+bool Samurai::remove(int num_remove, Clock::time_point deadline, const CancelToken* cancel, const Progress& progress) {
+    int tries = 0;
+    int total = num_remove;
+    effort = SearchStats();
+
+    std::vector<SamuraiSet> sets;
+    SamuraiSet clues;
+    bool use_ua = std::find(tiles.begin(), tiles.end(), 0) == tiles.end();
+    if (use_ua) {
+        sets = samurai_unavoidable(tiles);
+        clues = SAMURAI.all;
+    }
+
+    while (num_remove > 0 && tries < MAX_TRIES) {
+        if (Clock::now() >= deadline || (cancel && cancel->cancelled())) break;
+
+        int i = rand() % SAMURAI_CELLS;
+        if (tiles[i] == 0) continue;
+
+        if (use_ua) {
+            SamuraiSet rest = clues.minus(SamuraiSet::cell(i));
+            bool misses = false;
+            for (auto& set : sets) {
+                if (!(set & rest).any()) {
+                    misses = true;
+                    break;
+                }
+            }
+            if (misses) {
+                tries++;
+                continue;
+            }
+        }
+
+        int backup = tiles[i];
+        tiles[i] = 0;
+
+        if (is_unique_solvable(cancel)) {
+            clues = clues.minus(SamuraiSet::cell(i));
+            num_remove--;
+            if (progress) progress(total - num_remove, total);
+        } else {
+            tiles[i] = backup;
+            tries++;
+        }
+    }
+
+    return num_remove == 0;
+}
+
+bool Samurai::generate(int num_remove, Clock::time_point deadline, const CancelToken* cancel, const Progress& progress) {
+    SamuraiGrid start = tiles;
+
+    while (Clock::now() < deadline && !(cancel && cancel->cancelled())) {
+        if (progress) progress(0, num_remove);
+        clear();
+        if (!fill(GENERATE_NODES, deadline, cancel)) continue;
+        if (remove(num_remove, deadline, cancel, progress)) return true;
+    }
+
+    tiles = start;
+    return false;
+}
+
+bool parse_samurai(const char* line, size_t len, SamuraiGrid& grid) {
+    if (len < SAMURAI_LINE_CELLS) return false;
+
+    for (int i = 0; i < SAMURAI_CELLS; i++) {
+        char ch = line[i];
+        if (ch >= '1' && ch <= '9') grid[i] = ch - '0';
+        else if (ch == '.' || ch == '0') grid[i] = 0;
+        else return false;
+    }
+    return true;
+}
+
+void format_samurai(const SamuraiGrid& grid, char* out, char blank) {
+    for (int i = 0; i < SAMURAI_CELLS; i++)
+        out[i] = grid[i] == 0 ? blank : '0' + grid[i];
+}
+
+void print_samurai(FILE* stream, const SamuraiGrid& grid) {
+    char line[SAMURAI_SIDE + 2];
+    for (int l = 0; l < SAMURAI_SIDE; l++) {
+        for (int c = 0; c < SAMURAI_SIDE; c++) {
+            int i = SAMURAI.index[l][c];
+            line[c] = i == -1 ? ' ' : grid[i] == 0 ? '.' : '0' + grid[i];
+        }
+        int end = SAMURAI_SIDE;
+        while (end > 0 && line[end - 1] == ' ') end--;
+        line[end] = '\n';
+        line[end + 1] = '\0';
+        fputs(line, stream);
+    }
+}
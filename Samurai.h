@@ -0,0 +1,167 @@
+#ifndef SUDOKU_SAMURAI_H
+#define SUDOKU_SAMURAI_H
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "BitBoard.h"
+#include "Board.h"
+#include "Cancel.h"
+
+// Cinco grades 9x9 num quadro 21x21: quatro nos cantos e uma no centro, que
+// divide uma caixa com cada uma delas.
+#define SAMURAI_SIDE 21
+#define SAMURAI_GRIDS 5
+#define SAMURAI_CELLS 369
+// 5 * 27 casas, menos as 4 caixas compartilhadas contadas duas vezes.
+#define SAMURAI_HOUSES 131
+// Padrão de células em branco no gerador; jogos publicados ficam por volta de
+// 120 pistas.
+#define SAMURAI_REMOVE 240
+// Pedindo todas as células, a remoção aleatória para entre 257 e 269 células
+// em branco; 270 ainda sai em poucas tentativas, 275 já não sai em 100.
+#define SAMURAI_MAX_REMOVE 270
+// Uma linha de texto: 369 caracteres na ordem das células.
+#define SAMURAI_LINE_CELLS SAMURAI_CELLS
+
+// Células do samurai em ordem de linhas do quadro, pulando o que fica fora
+// das grades; 0 = célula vazia.
+typedef std::array<uint8_t, SAMURAI_CELLS> SamuraiGrid;
+
+// Conjunto de até 384 células em três Bits81.
+class SamuraiSet {
+private:
+    Bits81 part[3];
+public:
+
+    SamuraiSet() = default;
+
+    static SamuraiSet cell(int i) {
+        SamuraiSet s;
+        s.part[i >> 7] = Bits81::cell(i & 127);
+        return s;
+    }
+
+    SamuraiSet operator&(const SamuraiSet& o) const {
+        SamuraiSet s;
+        for (int k = 0; k < 3; k++) s.part[k] = part[k] & o.part[k];
+        return s;
+    }
+
+    SamuraiSet operator|(const SamuraiSet& o) const {
+        SamuraiSet s;
+        for (int k = 0; k < 3; k++) s.part[k] = part[k] | o.part[k];
+        return s;
+    }
+
+    // this & ~o
+    SamuraiSet minus(const SamuraiSet& o) const {
+        SamuraiSet s;
+        for (int k = 0; k < 3; k++) s.part[k] = part[k].minus(o.part[k]);
+        return s;
+    }
+
+    SamuraiSet& operator&=(const SamuraiSet& o) { return *this = *this & o; }
+
+    SamuraiSet& operator|=(const SamuraiSet& o) { return *this = *this | o; }
+
+    bool any() const { return part[0].any() || part[1].any() || part[2].any(); }
+
+    int count() const { return part[0].count() + part[1].count() + part[2].count(); }
+
+    // Índice do menor bit; o conjunto não pode ser vazio.
+    int first() const {
+        for (int k = 0; k < 2; k++)
+            if (part[k].any()) return (k << 7) + part[k].first();
+        return 256 + part[2].first();
+    }
+
+    bool test(int i) const { return part[i >> 7].test(i & 127); }
+};
+
+// Geometria do samurai, calculada uma vez: posição de cada célula, casas e
+// pares sobre o sistema inteiro, sem distinguir de qual grade cada uma veio.
+struct SamuraiLayout {
+    // Índice da célula na posição do quadro, ou -1 fora das grades.
+    int16_t index[SAMURAI_SIDE][SAMURAI_SIDE];
+    uint8_t row[SAMURAI_CELLS];
+    uint8_t col[SAMURAI_CELLS];
+    // Células de cada grade, em ordem de linhas.
+    uint16_t grid_cells[SAMURAI_GRIDS][81];
+    // Caixas de cada grade que outra grade também usa.
+    SamuraiSet shared[SAMURAI_GRIDS];
+    uint16_t houses[SAMURAI_HOUSES][9];
+    SamuraiSet house_mask[SAMURAI_HOUSES];
+    SamuraiSet peer_mask[SAMURAI_CELLS];
+    SamuraiSet all;
+
+    SamuraiLayout();
+};
+
+extern const SamuraiLayout SAMURAI;
+
+// Mesmo estado de busca do BitBoard, em planos de 369 bits: a propagação
+// atravessa as caixas compartilhadas sem nenhuma sincronização entre grades.
+class SamuraiBitBoard {
+public:
+    SamuraiSet planes[9];
+    SamuraiSet solved;
+
+    SamuraiBitBoard();
+
+    bool from_grid(const SamuraiGrid& grid);
+
+    SamuraiGrid to_grid() const;
+
+    void place(int cell, int digit);
+
+    bool propagate();
+
+    int branch_cell() const;
+
+    int count_solutions(int limit, SamuraiGrid* solution = nullptr, const CancelToken* cancel = nullptr) const;
+};
+
+// Jogo samurai: o mesmo preenchimento com reinícios e a mesma remoção com
+// teste de unicidade e conjuntos inevitáveis do Board, sobre as 369 células.
+class Samurai {
+private:
+    SamuraiGrid tiles = {};
+    // Busca que provou a unicidade do último jogo gerado por remove().
+    SearchStats effort;
+private:
+    bool fill_rec(long& nodes, Clock::time_point deadline, const CancelToken* cancel);
+public:
+
+    Samurai() = default;
+
+    const SamuraiGrid& get_grid() const { return tiles; }
+
+    void set_grid(const SamuraiGrid& grid) { tiles = grid; }
+
+    void clear() { tiles = {}; }
+
+    bool fill(long max_nodes, Clock::time_point deadline = Clock::time_point::max(),
+              const CancelToken* cancel = nullptr);
+
+    bool remove(int num_remove, Clock::time_point deadline = Clock::time_point::max(),
+                const CancelToken* cancel = nullptr, const Progress& progress = nullptr);
+
+    bool generate(int num_remove, Clock::time_point deadline = Clock::time_point::max(),
+                  const CancelToken* cancel = nullptr, const Progress& progress = nullptr);
+
+    bool is_unique_solvable(const CancelToken* cancel = nullptr);
+
+    int difficulty() const { return effort.backtracks; }
+};
+
+bool parse_samurai(const char* line, size_t len, SamuraiGrid& grid);
+
+void format_samurai(const SamuraiGrid& grid, char* out, char blank = '.');
+
+// Desenha o quadro 21x21, com espaços fora das grades.
+void print_samurai(FILE* stream, const SamuraiGrid& grid);
+
+#endif //SUDOKU_SAMURAI_H
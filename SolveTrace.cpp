@@ -0,0 +1,43 @@
+#include "SolveTrace.h"
+
+bool SolveTrace::try_push(const TraceEvent& event) {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == TRACE_CAPACITY) return false;
+    ring[h & (TRACE_CAPACITY - 1)] = event;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+bool SolveTrace::flush_pending() {
+    for (int i = 0; i < 81 && dirty.any(); i++) {
+        if (!dirty[i]) continue;
+        if (!try_push(pending[i])) return false;
+        dirty.reset(i);
+    }
+    return true;
+}
+
+void SolveTrace::reset() {
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    dirty.reset();
+    coalesced = 0;
+}
+
+// O rascunho sai antes do evento novo, para a ordem por célula se manter.
+void SolveTrace::push(uint8_t kind, int cell, int value) {
+    TraceEvent event = {kind, (uint8_t) cell, (uint8_t) value};
+    if ((dirty.none() || flush_pending()) && try_push(event)) return;
+
+    coalesced++;
+    pending[cell] = event;
+    dirty.set(cell);
+}
+
+bool SolveTrace::pop(TraceEvent& event) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return false;
+    event = ring[t & (TRACE_CAPACITY - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,55 @@
+#ifndef SUDOKU_SOLVETRACE_H
+#define SUDOKU_SOLVETRACE_H
+
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+// Potência de dois.
+#define TRACE_CAPACITY 4096
+
+enum TraceKind : uint8_t { TRACE_PLACE, TRACE_PROPAGATE, TRACE_BACKTRACK };
+
+// Célula `cell` passou a ter `value` (0 = vazia ao voltar da busca).
+struct TraceEvent {
+    uint8_t kind;
+    uint8_t cell;
+    uint8_t value;
+};
+
+// Fila circular sem travas entre uma única thread de busca (produtor) e o
+// renderizador (consumidor). O produtor nunca espera: com a fila cheia, os
+// eventos vão para um rascunho de 81 células em que o último valor de cada
+// célula substitui os anteriores, e o rascunho é despejado na fila assim
+// que houver espaço. O consumidor vê um salto, mas nunca um estado errado.
+class SolveTrace {
+private:
+    TraceEvent ring[TRACE_CAPACITY];
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+
+    // Só do produtor.
+    alignas(64) TraceEvent pending[81];
+    std::bitset<81> dirty;
+    size_t coalesced = 0;
+
+    bool try_push(const TraceEvent& event);
+
+    bool flush_pending();
+public:
+
+    // Só com produtor e consumidor parados.
+    void reset();
+
+    void push(uint8_t kind, int cell, int value);
+
+    bool pop(TraceEvent& event);
+
+    bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+
+    // Eventos absorvidos pelo rascunho; só vale ler no produtor ou depois dele.
+    size_t coalesced_events() const { return coalesced; }
+};
+
+#endif //SUDOKU_SOLVETRACE_H
@@ -0,0 +1,124 @@
+#include "SteppedSearch.h"
+
+#include <cstdlib>
+
+void SteppedSearch::start(Board& board, Mode mode, bool random, int limit) {
+    work.restore(board.snapshot());
+    this->mode = mode;
+    this->random = random;
+    this->limit = limit;
+    depth = 0;
+    sols = 0;
+    descend = true;
+    finished = false;
+}
+
+// Cada volta do laço ou abre um nível (escolhe a célula com menos candidatos)
+// ou tenta o próximo valor do nível do topo; só abrir um nível conta como nó.
+bool SteppedSearch::step(long& nodes) {
+    while (!finished) {
+        if (descend) {
+            if (nodes <= 0) return false;
+            nodes--;
+            descend = false;
+
+            Candidates cand;
+            work.candidates(cand);
+            if (cand.best == -1) {
+                if (sols++ == 0) solution = work.get_grid();
+                if (mode == FILL || sols >= limit) finished = true;
+                continue;
+            }
+
+            stack[depth++] = {cand.best, cand.mask[cand.best]};
+            continue;
+        }
+
+        if (depth == 0) {
+            finished = true;
+            break;
+        }
+
+        Frame& top = stack[depth - 1];
+        if (top.remaining == 0) {
+            work.set_tile(0, top.cell / 9, top.cell % 9);
+            depth--;
+            continue;
+        }
+
+        int bit = __builtin_ctz(top.remaining);
+        if (random) {
+            for (int skip = rand() % __builtin_popcount(top.remaining); skip > 0; skip--)
+                bit = __builtin_ctz(top.remaining & ~((2u << bit) - 1));
+        }
+        top.remaining &= ~(1u << bit);
+        work.set_tile(bit + 1, top.cell / 9, top.cell % 9);
+        descend = true;
+    }
+
+    return true;
+}
+
+void SteppedGenerator::start_fill() {
+    board.clear();
+    search.start(board, SteppedSearch::FILL, true);
+    phase = FILL;
+    removed = 0;
+    tries = 0;
+}
+
+// Sorteia a próxima célula a apagar e começa a busca de unicidade sem ela.
+void SteppedGenerator::next_removal() {
+    if (removed == num_remove) {
+        board.set_grid(board.get_grid());
+        phase = DONE;
+        return;
+    }
+    if (tries == MAX_TRIES) {
+        start_fill();
+        return;
+    }
+
+    do {
+        cell = rand() % 81;
+    } while (board.get_tile(cell / 9, cell % 9) == 0);
+
+    backup = board.get_tile(cell / 9, cell % 9);
+    board.set_tile(0, cell / 9, cell % 9);
+    search.start(board, SteppedSearch::COUNT, false, 2);
+    phase = REMOVE;
+}
+
+void SteppedGenerator::start(int num_remove) {
+    this->num_remove = num_remove;
+    start_fill();
+}
+
+bool SteppedGenerator::step(long nodes) {
+    while (nodes > 0 && phase != DONE && phase != IDLE) {
+        if (!search.step(nodes)) break;
+
+        if (phase == FILL) {
+            board.set_grid(search.first_solution());
+            next_removal();
+        } else {
+            if (search.solutions() == 1) {
+                removed++;
+            } else {
+                board.set_tile(backup, cell / 9, cell % 9);
+                tries++;
+            }
+            next_removal();
+        }
+    }
+
+    return phase == DONE;
+}
+
+bool SteppedGenerator::run_for(Clock::duration budget) {
+    Clock::time_point deadline = Clock::now() + budget;
+    while (!step(STEP_NODES)) {
+        if (phase == IDLE || Clock::now() >= deadline) return false;
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+#ifndef SUDOKU_STEPPEDSEARCH_H
+#define SUDOKU_STEPPEDSEARCH_H
+
+#include <cstdint>
+
+#include "Board.h"
+#include "sudoku.h"
+
+// Nós visitados entre duas consultas ao relógio em run_for().
+#define STEP_NODES 64
+
+// Busca com pilha explícita que pode parar depois de um número qualquer de
+// nós e continuar de onde parou, sem threads: cada quadro avança um pouco.
+// FILL para na primeira solução (resolver ou preencher); COUNT conta até
+// `limit` soluções (unicidade).
+class SteppedSearch {
+public:
+    enum Mode { FILL, COUNT };
+private:
+    struct Frame {
+        int cell;
+        uint16_t remaining;
+    };
+
+    Board work;
+    Frame stack[81];
+    int depth = 0;
+    bool descend = false;
+    bool finished = true;
+    Mode mode = FILL;
+    bool random = false;
+    int limit = 2;
+    int sols = 0;
+    Grid solution = {};
+public:
+
+    void start(Board& board, Mode mode, bool random, int limit = 2);
+
+    // Gasta até `nodes` nós (descontados do próprio argumento); true quando a
+    // busca terminou.
+    bool step(long& nodes);
+
+    bool done() const { return finished; }
+
+    int solutions() const { return sols; }
+
+    // Primeira solução encontrada; só vale se solutions() > 0.
+    const Grid& first_solution() const { return solution; }
+};
+
+// Geração de um jogo (preencher e depois remover células mantendo a solução
+// única) como máquina de estados sobre SteppedSearch.
+class SteppedGenerator {
+private:
+    enum Phase { IDLE, FILL, REMOVE, DONE };
+
+    Phase phase = IDLE;
+    Board board;
+    SteppedSearch search;
+    int num_remove = 0;
+    int removed = 0;
+    int tries = 0;
+    int cell = 0;
+    int backup = 0;
+
+    void start_fill();
+
+    void next_removal();
+public:
+
+    void start(int num_remove);
+
+    bool step(long nodes);
+
+    // Avança até terminar ou até passar `budget`; true quando terminou.
+    bool run_for(Clock::duration budget);
+
+    bool done() const { return phase == DONE; }
+
+    // Porcentagem de células já removidas.
+    int progress() const { return num_remove ? removed * 100 / num_remove : 0; }
+
+    Board& result() { return board; }
+};
+
+#endif //SUDOKU_STEPPEDSEARCH_H
@@ -0,0 +1,339 @@
+#include "Symmetry.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#define NUM_ORDERS 1296
+#define BLANK_KEY 10
+
+static const uint8_t PERM3[6][3] = {
+        {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}
+};
+
+// Todas as ordens de colunas alcançáveis: pilhas permutadas e colunas
+// permutadas dentro de cada pilha (6^4 = 1296).
+struct ColumnOrders {
+    uint8_t cols[NUM_ORDERS][9];
+
+    ColumnOrders() {
+        int n = 0;
+        for (auto& stacks : PERM3)
+            for (auto& p0 : PERM3)
+                for (auto& p1 : PERM3)
+                    for (auto& p2 : PERM3) {
+                        const uint8_t* inner[3] = {p0, p1, p2};
+                        for (int s = 0; s < 3; s++)
+                            for (int k = 0; k < 3; k++)
+                                cols[n][s * 3 + k] = stacks[s] * 3 + inner[s][k];
+                        n++;
+                    }
+    }
+};
+
+static const ColumnOrders ORDERS;
+
+// Estado parcial da busca: linhas já escolhidas e a renomeação de dígitos
+// induzida pelo prefixo construído até aqui.
+struct Partial {
+    uint16_t order;
+    uint16_t rows_used;
+    uint8_t transposed;
+    uint8_t band;
+    uint8_t next_label;
+    uint8_t labels[10];
+};
+
+static int perm_index(int a, int b, int c) {
+    for (int i = 0; i < 6; i++)
+        if (PERM3[i][0] == a && PERM3[i][1] == b && PERM3[i][2] == c) return i;
+    return 0;
+}
+
+// Índice em ORDERS da ordem em que a posição k recebe a coluna sigma[k].
+static int order_index(const int8_t sigma[9]) {
+    int n = perm_index(sigma[0] / 3, sigma[3] / 3, sigma[6] / 3);
+    for (int s = 0; s < 3; s++)
+        n = n * 6 + perm_index(sigma[s * 3] % 3, sigma[s * 3 + 1] % 3, sigma[s * 3 + 2] % 3);
+    return n;
+}
+
+// Ordem de colunas montada posição a posição; -1 onde ainda está livre.
+struct ColumnSeed {
+    int8_t sigma[9];
+    int8_t pos[9];
+    int8_t slot_stack[3];
+    int8_t stack_slot[3];
+};
+
+// Com a primeira linha completa, ela vira sempre 1..9 e o rótulo de cada
+// dígito é a posição da sua coluna. A segunda linha é montada escolhendo a
+// coluna de cada posição; quando o rótulo ainda depende de uma coluna não
+// posicionada, ela vai para a primeira posição livre possível, a única que
+// dá o menor valor ali. Só as ordens que empatam no mínimo sobram.
+struct SecondRow {
+    const uint8_t* first;
+    const uint8_t* row;
+    uint8_t column_of[10];
+    uint8_t key[9];
+    uint8_t best[9];
+    bool have_best = false;
+    std::vector<Partial> found;
+    Partial base;
+
+    void search(ColumnSeed seed, int k) {
+        if (k == 9) {
+            int cmp = have_best ? memcmp(key, best, 9) : -1;
+            if (cmp > 0) return;
+            if (cmp < 0) {
+                found.clear();
+                std::memcpy(best, key, 9);
+                have_best = true;
+            }
+
+            Partial q = base;
+            q.order = order_index(seed.sigma);
+            for (int j = 0; j < 9; j++) q.labels[first[seed.sigma[j]]] = j + 1;
+            q.next_label = 9;
+            found.push_back(q);
+            return;
+        }
+
+        int slot = k / 3;
+        for (int c = 0; c < 9; c++) {
+            if (seed.sigma[k] >= 0) {
+                if (c != seed.sigma[k]) continue;
+            } else {
+                if (seed.pos[c] >= 0) continue;
+                if (seed.slot_stack[slot] >= 0 ? c / 3 != seed.slot_stack[slot] : seed.stack_slot[c / 3] >= 0)
+                    continue;
+            }
+
+            ColumnSeed next = seed;
+            next.sigma[k] = c;
+            next.pos[c] = k;
+            next.slot_stack[slot] = c / 3;
+            next.stack_slot[c / 3] = slot;
+
+            int val = row[c];
+            if (val == 0) key[k] = BLANK_KEY;
+            else {
+                int col = column_of[val];
+                if (next.pos[col] < 0) {
+                    int to = next.stack_slot[col / 3];
+                    if (to < 0) {
+                        to = 0;
+                        while (next.slot_stack[to] >= 0) to++;
+                        next.slot_stack[to] = col / 3;
+                        next.stack_slot[col / 3] = to;
+                    }
+                    int q = to * 3;
+                    while (next.sigma[q] >= 0) q++;
+                    next.sigma[q] = col;
+                    next.pos[col] = q;
+                }
+                key[k] = next.pos[col] + 1;
+            }
+
+            if (have_best && memcmp(key, best, k + 1) > 0) continue;
+            search(next, k + 1);
+        }
+    }
+};
+
+// Linhas e colunas sem dígito repetido e com alguma delas completa: o
+// primeiro nível é sempre 1..9, e os dois primeiros saem de SecondRow em vez
+// de testar as 1296 ordens de colunas.
+static bool seed_two_rows(const uint8_t g[2][81], std::vector<Partial>& cur, Grid& result) {
+    bool any_full = false;
+    for (int t = 0; t < 2; t++) {
+        for (int r = 0; r < 9; r++) {
+            int seen = 0, filled = 0;
+            for (int c = 0; c < 9; c++) {
+                int val = g[t][r * 9 + c];
+                if (val == 0) continue;
+                if (seen & (1 << val)) return false;
+                seen |= 1 << val;
+                filled++;
+            }
+            any_full |= filled == 9;
+        }
+    }
+    if (!any_full) return false;
+
+    SecondRow second;
+    for (int t = 0; t < 2; t++) {
+        for (int r = 0; r < 9; r++) {
+            const uint8_t* first = &g[t][r * 9];
+            if (std::find(first, first + 9, 0) != first + 9) continue;
+
+            second.first = first;
+            for (int c = 0; c < 9; c++) second.column_of[first[c]] = c;
+            for (int r2 = r / 3 * 3; r2 < r / 3 * 3 + 3; r2++) {
+                if (r2 == r) continue;
+                second.row = &g[t][r2 * 9];
+                second.base = {};
+                second.base.transposed = t;
+                second.base.rows_used = (1 << r) | (1 << r2);
+                second.base.band = r / 3;
+
+                ColumnSeed seed;
+                std::fill(seed.sigma, seed.sigma + 9, -1);
+                std::fill(seed.pos, seed.pos + 9, -1);
+                std::fill(seed.slot_stack, seed.slot_stack + 3, -1);
+                std::fill(seed.stack_slot, seed.stack_slot + 3, -1);
+                second.search(seed, 0);
+            }
+        }
+    }
+
+    for (int k = 0; k < 9; k++) {
+        result[k] = k + 1;
+        result[9 + k] = second.best[k] == BLANK_KEY ? 0 : second.best[k];
+    }
+    cur.swap(second.found);
+    return true;
+}
+
+// Busca em largura linha a linha: a cada nível só sobrevivem os estados cujo
+// prefixo renomeado é lexicograficamente mínimo. Células vazias valem mais que
+// qualquer dígito, então as pistas vão para o início e os empates somem cedo.
+Grid canonical_form(const Grid& grid) {
+    uint8_t g[2][81];
+    for (int l = 0; l < 9; l++) {
+        for (int c = 0; c < 9; c++) {
+            g[0][l * 9 + c] = grid[l * 9 + c];
+            g[1][c * 9 + l] = grid[l * 9 + c];
+        }
+    }
+
+    std::vector<Partial> cur, next;
+    Grid result;
+    int start = 0;
+    if (seed_two_rows(g, cur, result)) {
+        start = 2;
+    } else {
+        cur.reserve(2 * NUM_ORDERS);
+        for (int t = 0; t < 2; t++) {
+            for (int o = 0; o < NUM_ORDERS; o++) {
+                Partial p = {};
+                p.order = o;
+                p.transposed = t;
+                cur.push_back(p);
+            }
+        }
+    }
+
+    for (int level = start; level < 9; level++) {
+        uint8_t best[9];
+        bool have_best = false;
+        next.clear();
+
+        for (const Partial& p : cur) {
+            uint16_t choices;
+            if (level % 3 == 0) {
+                choices = 0;
+                for (int b = 0; b < 3; b++)
+                    if (!(p.rows_used & (7 << (b * 3))))
+                        choices |= 7 << (b * 3);
+            } else {
+                choices = (7 << (p.band * 3)) & ~p.rows_used;
+            }
+
+            for (int r = 0; r < 9; r++) {
+                if (!(choices & (1 << r))) continue;
+
+                const uint8_t* row = &g[p.transposed][r * 9];
+                const uint8_t* cols = ORDERS.cols[p.order];
+
+                uint8_t labels[10];
+                std::memcpy(labels, p.labels, sizeof(labels));
+                uint8_t next_label = p.next_label;
+                uint8_t key[9];
+                int cmp = have_best ? 0 : -1;
+                int k;
+                for (k = 0; k < 9; k++) {
+                    int val = row[cols[k]];
+                    if (val == 0) key[k] = BLANK_KEY;
+                    else {
+                        if (labels[val] == 0) labels[val] = ++next_label;
+                        key[k] = labels[val];
+                    }
+
+                    if (cmp == 0) {
+                        if (key[k] > best[k]) break;
+                        if (key[k] < best[k]) cmp = -1;
+                    }
+                }
+                if (k < 9) continue;
+
+                if (cmp < 0) {
+                    next.clear();
+                    std::memcpy(best, key, 9);
+                    have_best = true;
+                }
+
+                Partial q = p;
+                std::memcpy(q.labels, labels, sizeof(labels));
+                q.next_label = next_label;
+                q.rows_used |= 1 << r;
+                q.band = r / 3;
+                next.push_back(q);
+            }
+        }
+
+        for (int k = 0; k < 9; k++)
+            result[level * 9 + k] = best[k] == BLANK_KEY ? 0 : best[k];
+        std::swap(cur, next);
+    }
+
+    return result;
+}
+
+static void random_order(int order[9]) {
+    const uint8_t* outer = PERM3[rand() % 6];
+    for (int b = 0; b < 3; b++) {
+        const uint8_t* inner = PERM3[rand() % 6];
+        for (int k = 0; k < 3; k++)
+            order[b * 3 + k] = outer[b] * 3 + inner[k];
+    }
+}
+
+Grid random_transform(const Grid& grid) {
+    int rows[9], cols[9];
+    random_order(rows);
+    random_order(cols);
+
+    uint8_t digits[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    for (int k = 9; k > 1; k--)
+        std::swap(digits[k], digits[1 + rand() % k]);
+
+    bool transpose = rand() % 2;
+
+    Grid result;
+    for (int l = 0; l < 9; l++) {
+        for (int c = 0; c < 9; c++) {
+            int src = transpose ? cols[c] * 9 + rows[l] : rows[l] * 9 + cols[c];
+            result[l * 9 + c] = digits[grid[src]];
+        }
+    }
+    return result;
+}
+
+uint64_t grid_hash(const Grid& grid) {
+    // FNV-1a seguido de uma mistura final para espalhar os bits altos.
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (uint8_t val : grid) {
+        h ^= val;
+        h *= 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t canonical_hash(const Grid& grid) {
+    return grid_hash(canonical_form(grid));
+}
@@ -0,0 +1,21 @@
+#ifndef SUDOKU_SYMMETRY_H
+#define SUDOKU_SYMMETRY_H
+
+#include <cstdint>
+
+#include "sudoku.h"
+
+// Representante canônico sob as 3.359.232 simetrias do tabuleiro (transposição,
+// troca de bandas/pilhas e de linhas/colunas dentro delas) e renomeação dos
+// dígitos. Dois tabuleiros equivalentes têm exatamente a mesma forma canônica.
+Grid canonical_form(const Grid& grid);
+
+// Aplica uma simetria aleatória (bandas, pilhas, linhas, colunas, transposição
+// e renomeação de dígitos). Preserva validade e unicidade da solução.
+Grid random_transform(const Grid& grid);
+
+uint64_t grid_hash(const Grid& grid);
+
+uint64_t canonical_hash(const Grid& grid);
+
+#endif //SUDOKU_SYMMETRY_H
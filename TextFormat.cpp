@@ -0,0 +1,107 @@
+#include "TextFormat.h"
+
+#include <cstring>
+
+#define STREAM_CHUNK (1 << 20)
+
+bool parse_line(const char* line, size_t len, Grid& grid) {
+    if (len < LINE_CELLS) return false;
+    if (len > LINE_CELLS && line[LINE_CELLS] != ' ' && line[LINE_CELLS] != '\t' && line[LINE_CELLS] != '\r')
+        return false;
+
+    // Sem desvios dentro do laço, para o compilador poder vetorizar.
+    uint8_t bad = 0;
+    for (int k = 0; k < LINE_CELLS; k++) {
+        uint8_t ch = line[k];
+        uint8_t digit = ch - '0';
+        uint8_t dot = ch == '.';
+        bad |= (digit > 9) & !dot;
+        grid[k] = dot ? 0 : digit;
+    }
+    return !bad;
+}
+
+void format_line(const Grid& grid, char* out, char blank) {
+    for (int k = 0; k < LINE_CELLS; k++)
+        out[k] = grid[k] == 0 ? blank : '0' + grid[k];
+}
+
+bool PuzzleReader::open(const std::string& path) {
+    invalid = 0;
+    if (path == "-") {
+        stream = stdin;
+        buffer.resize(STREAM_CHUNK);
+        pos = end = buffer.data();
+        return true;
+    }
+
+    stream = nullptr;
+    if (!file.open(path)) return false;
+    pos = reinterpret_cast<const char*>(file.bytes());
+    end = pos + file.size();
+    return true;
+}
+
+// Move o resto da linha corrente para o início do buffer e lê mais um bloco.
+bool PuzzleReader::refill() {
+    if (stream == nullptr) return false;
+
+    // Move antes de crescer: o resize pode realocar o buffer para onde pos aponta.
+    size_t rest = end - pos;
+    std::memmove(buffer.data(), pos, rest);
+    if (rest == buffer.size()) buffer.resize(buffer.size() * 2);
+
+    size_t got = fread(buffer.data() + rest, 1, buffer.size() - rest, stream);
+    pos = buffer.data();
+    end = pos + rest + got;
+    return got > 0;
+}
+
+bool PuzzleReader::next(Grid& grid) {
+    while (true) {
+        const char* nl = pos < end ? static_cast<const char*>(std::memchr(pos, '\n', end - pos)) : nullptr;
+        if (nl == nullptr) {
+            if (refill()) continue;
+            if (pos == end) return false;
+            nl = end;
+        }
+
+        const char* line = pos;
+        size_t len = nl - line;
+        pos = nl < end ? nl + 1 : end;
+
+        if (len > 0 && line[len - 1] == '\r') len--;
+        if (len == 0 || line[0] == '#') continue;
+
+        if (parse_line(line, len, grid)) return true;
+        invalid++;
+    }
+}
+
+size_t PuzzleReader::invalid_lines() {
+    return invalid;
+}
+
+PuzzleWriter::PuzzleWriter(FILE* stream) : stream(stream), buffer(STREAM_CHUNK) {}
+
+PuzzleWriter::~PuzzleWriter() {
+    flush();
+}
+
+void PuzzleWriter::write(const Grid& grid, const char* suffix) {
+    size_t extra = suffix ? std::strlen(suffix) : 0;
+    if (used + LINE_CELLS + extra + 1 > buffer.size()) flush();
+
+    format_line(grid, buffer.data() + used);
+    used += LINE_CELLS;
+    if (extra > 0) {
+        std::memcpy(buffer.data() + used, suffix, extra);
+        used += extra;
+    }
+    buffer[used++] = '\n';
+}
+
+void PuzzleWriter::flush() {
+    if (used > 0) fwrite(buffer.data(), 1, used, stream);
+    used = 0;
+}
@@ -0,0 +1,61 @@
+#ifndef SUDOKU_TEXTFORMAT_H
+#define SUDOKU_TEXTFORMAT_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "sudoku.h"
+
+// Formato padrão de 81 caracteres por linha: '1'..'9' para pistas e '.' ou
+// '0' para células vazias. O que vier depois do 81º caractere é ignorado.
+#define LINE_CELLS 81
+
+bool parse_line(const char* line, size_t len, Grid& grid);
+
+void format_line(const Grid& grid, char* out, char blank = '.');
+
+// Lê um tabuleiro por linha de um arquivo mapeado em memória ou, para "-",
+// da entrada padrão em blocos. Nenhuma alocação por linha; linhas vazias e
+// comentários ('#') são pulados e linhas malformadas apenas contadas.
+class PuzzleReader {
+private:
+    MappedFile file;
+    FILE* stream = nullptr;
+    std::vector<char> buffer;
+    const char* pos = nullptr;
+    const char* end = nullptr;
+    size_t invalid = 0;
+private:
+    bool refill();
+public:
+
+    PuzzleReader() = default;
+
+    bool open(const std::string& path);
+
+    bool next(Grid& grid);
+
+    size_t invalid_lines();
+};
+
+// Escreve tabuleiros no formato de 81 caracteres, acumulando em um buffer.
+class PuzzleWriter {
+private:
+    FILE* stream;
+    std::vector<char> buffer;
+    size_t used = 0;
+public:
+
+    explicit PuzzleWriter(FILE* stream);
+
+    ~PuzzleWriter();
+
+    void write(const Grid& grid, const char* suffix = nullptr);
+
+    void flush();
+};
+
+#endif //SUDOKU_TEXTFORMAT_H
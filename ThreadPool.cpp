@@ -0,0 +1,103 @@
+#include "ThreadPool.h"
+
+// Índice da fila do worker corrente, -1 fora do pool.
+static thread_local int current_worker = -1;
+static thread_local ThreadPool* current_pool = nullptr;
+
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0) threads = std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+
+    for (int t = 0; t < threads; t++) queues.emplace_back(new Queue());
+    for (int t = 0; t < threads; t++) workers.emplace_back(&ThreadPool::worker_loop, this, t);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+int ThreadPool::size() {
+    return workers.size();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    int target = current_pool == this ? current_worker : next_queue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        queued++;
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::take(int self, std::function<void()>& task) {
+    int n = queues.size();
+    if (self >= 0) {
+        std::lock_guard<std::mutex> lock(queues[self]->mutex);
+        if (!queues[self]->tasks.empty()) {
+            task = std::move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    int start = self >= 0 ? self + 1 : 0;
+    for (int k = 0; k < n; k++) {
+        Queue& victim = *queues[(start + k) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::run_one() {
+    std::function<void()> task;
+    if (!take(current_pool == this ? current_worker : -1, task)) return false;
+    task();
+    return true;
+}
+
+void ThreadPool::worker_loop(int self) {
+    current_worker = self;
+    current_pool = this;
+
+    while (true) {
+        std::function<void()> task;
+        if (take(self, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [&] { return queued > 0 || stop; });
+        if (stop && queued == 0) return;
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    pending++;
+    pool.submit([this, task = std::move(task)] {
+        task();
+        pending--;
+    });
+}
+
+void TaskGroup::wait() {
+    while (pending > 0) {
+        if (!pool.run_one()) std::this_thread::yield();
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef SUDOKU_THREADPOOL_H
+#define SUDOKU_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool com roubo de tarefas: cada worker tem sua própria fila, consome pelo
+// fim e, quando ela esvazia, rouba pelo início das filas dos outros.
+class ThreadPool {
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<int> queued{0};
+    std::atomic<unsigned> next_queue{0};
+    std::atomic<bool> stop{false};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+private:
+    bool take(int self, std::function<void()>& task);
+
+    void worker_loop(int self);
+public:
+
+    explicit ThreadPool(int threads = 0);
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+    int size();
+
+    void submit(std::function<void()> task);
+
+    bool run_one();
+};
+
+// Grupo de tarefas que pode ser aguardado. Quem espera também executa
+// tarefas pendentes, então esperar de dentro de um worker não trava o pool.
+class TaskGroup {
+private:
+    ThreadPool& pool;
+    std::atomic<int> pending{0};
+public:
+
+    explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+
+    void run(std::function<void()> task);
+
+    void wait();
+};
+
+#endif //SUDOKU_THREADPOOL_H
@@ -0,0 +1,86 @@
+#include "Unavoidable.h"
+
+#include <algorithm>
+
+// Enumera as soluções de `board` (até UA_MAX_SOLUTIONS) e guarda as células
+// que diferem de `solution`.
+static void enumerate(BitBoard board, const Grid& solution, std::vector<Bits81>& found) {
+    if (found.size() >= UA_MAX_SOLUTIONS || !board.propagate()) return;
+
+    if (board.solved.count() == 81) {
+        Grid grid = board.to_grid();
+        Bits81 diff;
+        for (int i = 0; i < 81; i++)
+            if (grid[i] != solution[i]) diff |= Bits81::cell(i);
+        if (diff.any()) found.push_back(diff);
+        return;
+    }
+
+    int cell = board.branch_cell();
+    for (int d = 0; d < 9; d++) {
+        if (!board.planes[d].test(cell)) continue;
+        BitBoard next = board;
+        next.place(cell, d);
+        enumerate(next, solution, found);
+    }
+}
+
+void Unavoidable::build(const Grid& solution, int max_digits) {
+    std::vector<Bits81> found;
+
+    for (int mask = 0; mask < 512; mask++) {
+        int n = __builtin_popcount(mask);
+        if (n < 2 || n > max_digits) continue;
+
+        Grid partial = solution;
+        for (auto& val : partial)
+            if (mask & (1 << (val - 1))) val = 0;
+
+        BitBoard board;
+        if (!board.from_grid(partial)) continue;
+
+        std::vector<Bits81> diffs;
+        enumerate(board, solution, diffs);
+        found.insert(found.end(), diffs.begin(), diffs.end());
+    }
+
+    std::sort(found.begin(), found.end(), [](const Bits81& a, const Bits81& b) { return a.count() < b.count(); });
+
+    sets.clear();
+    for (auto& set : found) {
+        bool minimal = true;
+        for (auto& kept : sets) {
+            if (!kept.minus(set).any()) {
+                minimal = false;
+                break;
+            }
+        }
+        if (minimal) sets.push_back(set);
+        if (sets.size() == UA_MAX_SETS) break;
+    }
+}
+
+Bits81 Unavoidable::shrink(const Grid& solution, Bits81 set) {
+    for (;;) {
+        Grid partial = solution;
+        for (int i = 0; i < 81; i++)
+            if (set.test(i)) partial[i] = 0;
+
+        BitBoard board;
+        board.from_grid(partial);
+        std::vector<Bits81> diffs;
+        enumerate(board, solution, diffs);
+
+        Bits81 best = set;
+        for (auto& diff : diffs)
+            if (diff.count() < best.count()) best = diff;
+        if (best.count() == set.count()) return set;
+        set = best;
+    }
+}
+
+bool Unavoidable::misses(const Bits81& clues) const {
+    for (auto& set : sets)
+        if (!(set & clues).any()) return true;
+    return false;
+}
@@ -1,6 +1,10 @@
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <map>
 #include <optional>
 #include <string>
+#include <thread>
 
 #include <getopt.h>
 
@@ -9,7 +13,18 @@
 #include <SDL2/SDL2_gfxPrimitives.h>
 
 #include "sudoku.h"
+#include "BitBoard.h"
 #include "Board.h"
+#include "Constraints.h"
+#include "Corpus.h"
+#include "Grader.h"
+#include "Killer.h"
+#include "Portfolio.h"
+#include "SteppedSearch.h"
+#include "Symmetry.h"
+
+// A janela é desenhada para o tamanho do tabuleiro do jogo.
+static_assert(Board::BOX == BOARD_BOX, "BOARD_BOX difere do Board");
 
 void exit_sdl_error(std::string msg) {
     fprintf(stderr, "%s: %s\n", msg.c_str(), SDL_GetError());
@@ -55,13 +70,13 @@ void end_graphics(Graphics& gpx) {
 }
 
 int get_win_x(int x) {
-    int n_thick = 1 + x / 3;
+    int n_thick = 1 + x / BOARD_BOX;
     int n_thin = x - n_thick + 1;
     return n_thick * THICK_PAD + n_thin * THIN_PAD + CELL_WIDTH * x;
 }
 
 int get_win_y(int y) {
-    int n_thick = 2 + y / 3;
+    int n_thick = 2 + y / BOARD_BOX;
     int n_thin = y - n_thick + 1;
     return n_thick * THICK_PAD + n_thin * THIN_PAD + CELL_WIDTH * y + CELL_WIDTH;
 }
@@ -86,10 +101,11 @@ void draw_number(Graphics& gpx, int num, int x_win, int y_win, SDL_Color color,
     SDL_DestroyTexture(Message);
 }
 
-void draw_header(Graphics& gpx, Board& board, State& stat, Options& opts) {
+void draw_header(Graphics& gpx, Candidates& cand, State& stat, Options& opts) {
     // Possíveis números
-    for (int k = 1; k <= 9; k++) {
-        if (opts.hints && board.is_allowed(k, stat.y, stat.x))
+    uint16_t allowed = cand.mask[stat.y * BOARD_SIDE + stat.x];
+    for (int k = 1; k <= BOARD_SIDE; k++) {
+        if (opts.hints && (allowed & (1 << (k - 1))))
             circleRGBA(gpx.ren, get_win_x(k - 1) + CELL_WIDTH / 2, THICK_PAD + CELL_WIDTH / 2, CELL_WIDTH / 2, 255, 160, 0, 255);
 
         SDL_Color color = {0, 150, 255, 255};
@@ -98,9 +114,19 @@ void draw_header(Graphics& gpx, Board& board, State& stat, Options& opts) {
     }
 }
 
-void draw_board(Graphics& gpx, Board& board, State& stat, Options& opts) {
-    for (int l = 0; l < 9; l++) {
-        for (int c = 0; c < 9; c++) {
+// Cor da borda de cada região do jigsaw.
+static const SDL_Color REGION_COLORS[9] = {
+        {255, 255, 255, 255}, {255, 140, 140, 255}, {140, 200, 255, 255},
+        {170, 255, 140, 255}, {255, 200, 120, 255}, {210, 150, 255, 255},
+        {120, 240, 220, 255}, {255, 150, 220, 255}, {200, 200, 140, 255},
+};
+
+void draw_board(Graphics& gpx, Board& board, Candidates& cand, State& stat, Options& opts) {
+    const ConstraintTable& table = rules();
+
+    for (int l = 0; l < BOARD_SIDE; l++) {
+        for (int c = 0; c < BOARD_SIDE; c++) {
+            uint16_t allowed = cand.mask[l * BOARD_SIDE + c];
             int x_win = get_win_x(c);
             int y_win = get_win_y(l);
 
@@ -108,8 +134,20 @@ void draw_board(Graphics& gpx, Board& board, State& stat, Options& opts) {
             int g = 255;
             int b = 255;
 
+            // Células de casas extras (diagonais, janelas) ficam com fundo.
+            if (table.num_cell_houses[l * BOARD_SIDE + c] > 3)
+                roundedBoxRGBA(gpx.ren, x_win, y_win, x_win + CELL_WIDTH, y_win + CELL_WIDTH, 8, 70, 70, 90, 255);
+
+            // No jigsaw a cor da borda indica a região.
+            if (table.kernel_houses < 27) {
+                const SDL_Color& region = REGION_COLORS[table.box_of[l * BOARD_SIDE + c]];
+                r = region.r;
+                g = region.g;
+                b = region.b;
+            }
+
             if (opts.hints && stat.highlight != 0) {
-                if  (!board.is_allowed(stat.highlight, l, c)) {
+                if  (!(allowed & (1 << (stat.highlight - 1)))) {
                     r = 100;
                     g = 100;
                     b = 100;
@@ -137,10 +175,10 @@ void draw_board(Graphics& gpx, Board& board, State& stat, Options& opts) {
 
             if (board.get_tile(l, c) != 0 || !opts.annotations) continue;
 
-            for (int ll = 0; ll < 3; ll++) {
-                for (int cc = 0; cc < 3; cc++) {
-                    int value = ll * 3 + cc + 1;
-                    if (board.is_allowed(value, l, c)) {
+            for (int ll = 0; ll < BOARD_BOX; ll++) {
+                for (int cc = 0; cc < BOARD_BOX; cc++) {
+                    int value = ll * BOARD_BOX + cc + 1;
+                    if (allowed & (1 << (value - 1))) {
                         draw_number(gpx, value, x_win + 8 + 14 * cc, y_win + 3 + 14 * ll, color, true);
                     }
                 }
@@ -149,6 +187,50 @@ void draw_board(Graphics& gpx, Board& board, State& stat, Options& opts) {
     }
 }
 
+// Gaiolas do jogo atual; vazio fora do killer.
+static Killer killer;
+
+// Contorno das gaiolas do killer, um pouco por fora das células. Um lado vira
+// linha quando a vizinha é de outra gaiola; a linha atravessa o vão até a
+// vizinha seguinte quando ela tem o mesmo lado, para o contorno ficar contínuo.
+void draw_cages(Graphics& gpx) {
+    auto same = [](int cell, int l, int c) {
+        return l >= 0 && l < 9 && c >= 0 && c < 9 && killer.cage_at(l * 9 + c) == killer.cage_at(cell);
+    };
+
+    for (int i = 0; i < 81; i++) {
+        if (killer.cage_at(i) == -1) continue;
+
+        int l = i / 9, c = i % 9;
+        int left = get_win_x(c) - CAGE_INSET;
+        int right = get_win_x(c) + CELL_WIDTH + CAGE_INSET;
+        int top = get_win_y(l) - CAGE_INSET;
+        int bottom = get_win_y(l) + CELL_WIDTH + CAGE_INSET;
+
+        if (!same(i, l - 1, c)) {
+            int end = same(i, l, c + 1) && !same(i, l - 1, c + 1) ? get_win_x(c + 1) - CAGE_INSET : right;
+            lineRGBA(gpx.ren, left, top, end, top, 150, 150, 200, 255);
+        }
+        if (!same(i, l + 1, c)) {
+            int end = same(i, l, c + 1) && !same(i, l + 1, c + 1) ? get_win_x(c + 1) - CAGE_INSET : right;
+            lineRGBA(gpx.ren, left, bottom, end, bottom, 150, 150, 200, 255);
+        }
+        if (!same(i, l, c - 1)) {
+            int end = same(i, l + 1, c) && !same(i, l + 1, c - 1) ? get_win_y(l + 1) - CAGE_INSET : bottom;
+            lineRGBA(gpx.ren, left, top, left, end, 150, 150, 200, 255);
+        }
+        if (!same(i, l, c + 1)) {
+            int end = same(i, l + 1, c) && !same(i, l + 1, c + 1) ? get_win_y(l + 1) - CAGE_INSET : bottom;
+            lineRGBA(gpx.ren, right, top, right, end, 150, 150, 200, 255);
+        }
+    }
+
+    // Soma no canto da primeira célula de cada gaiola.
+    SDL_Color color = {200, 200, 255, SDL_ALPHA_OPAQUE};
+    for (auto& cage : killer.get_cages())
+        draw_number(gpx, cage.sum, get_win_x(cage.first % 9) + 3, get_win_y(cage.first / 9), color, true);
+}
+
 void draw_selection(Graphics& gpx, State& stat) {
     /*SDL_SetRenderDrawColor(gpx.ren, 255, 160, 0x00, 0xFF);
     SDL_Rect rect = {get_win_x(stat.x), get_win_y(stat.y), CELL_WIDTH, CELL_WIDTH};
@@ -171,22 +253,40 @@ void draw(Graphics& gpx, State& stat, Board& board, Options& opts) {
     SDL_SetRenderDrawColor(gpx.ren, 40, 40, 40, 255);
     SDL_RenderClear(gpx.ren);
 
-    draw_board(gpx, board, stat, opts);
+    Candidates cand;
+    board.candidates(cand);
+    Grid grid = board.get_grid();
+    killer.restrict(grid.data(), cand);
+
+    draw_board(gpx, board, cand, stat, opts);
+    draw_cages(gpx);
 
     if (stat.selected) {
         draw_selection(gpx, stat);
-        draw_header(gpx, board, stat, opts);
+        draw_header(gpx, cand, stat, opts);
     }
 
-    char buffer[50];
-    snprintf(buffer, 50, "Sudoku - Nível: %.0lf %%", (double) opts.num_remove / 58.0 * 100.0);
+    // Barra de progresso da geração em andamento, na faixa do cabeçalho.
+    if (stat.pending_reset) {
+        int left = get_win_x(0);
+        int right = get_win_x(BOARD_SIDE - 1) + CELL_WIDTH;
+        int y = THICK_PAD + CELL_WIDTH - 6;
+        rectangleRGBA(gpx.ren, left, y, right, y + 4, 0, 150, 255, 255);
+        boxRGBA(gpx.ren, left, y, left + (right - left) * stat.progress / 100, y + 4, 0, 150, 255, 255);
+    }
+
+    char buffer[64];
+    if (opts.killer)
+        snprintf(buffer, 64, "Sudoku killer %s - Nível: %.0lf %%", variant_name(opts.variant), (double) opts.num_remove / 58.0 * 100.0);
+    else
+        snprintf(buffer, 64, "Sudoku %s - Nível: %.0lf %%", variant_name(opts.variant), (double) opts.num_remove / 58.0 * 100.0);
 
     SDL_SetWindowTitle(gpx.win, buffer);
     SDL_RenderPresent(gpx.ren);
 }
 
 int grid_coords_y(int win_y) {
-    for (int l = 0; l < 9; l++) {
+    for (int l = 0; l < BOARD_SIDE; l++) {
         int aux = get_win_y(l);
         if (aux < win_y && aux + CELL_WIDTH > win_y) return l;
     }
@@ -194,7 +294,7 @@ int grid_coords_y(int win_y) {
 }
 
 int grid_coords_x(int win_x) {
-    for (int c = 0; c < 9; c++) {
+    for (int c = 0; c < BOARD_SIDE; c++) {
         int aux = get_win_x(c);
         if (aux < win_x && aux + CELL_WIDTH > win_x) return c;
     }
@@ -211,15 +311,375 @@ std::optional<Coords> grid_coords(int win_x, int win_y) {
     return std::make_pair(y_grid, x_grid);
 }
 
-void reset_board(Board& board, Options& opts) {
-    board.clear();
-    board.fill(true);
-    while (!board.remove(opts.num_remove)) {
-        board.clear();
-        board.fill(true);
+// Sementes já verificadas por nível; no modo instantâneo um novo jogo é só
+// uma simetria aleatória da semente, sem nova busca de unicidade.
+static std::map<int, Grid> seeds;
+
+// Tabuleiros pré-gerados offline (sudoku-corpus), quando o arquivo existe.
+static Corpus corpus;
+
+#ifndef SUDOKU_NO_THREADS
+
+// Modo de assistir a busca (-v): o resolvedor roda numa thread e publica cada
+// passo num SolveTrace, sem nunca esperar; o laço principal aplica
+// opts.watch_rate eventos por quadro e, no fim, o resultado exato.
+struct Watch {
+    std::thread thread;
+    SolveTrace trace;
+    CancelToken cancel;
+    std::atomic<bool> finished{false};
+    bool active = false;
+    bool solved = false;
+    Grid solution;
+    Board::Snapshot before;
+};
+
+static Watch watch;
+
+void join_watch() {
+    if (watch.thread.joinable()) watch.thread.join();
+    watch.active = false;
+}
+
+// Abandona a animação em curso: cancela a busca e devolve o tabuleiro ao
+// estado de antes, sem as células que o rastro já tinha preenchido.
+void stop_watch(Board& board) {
+    if (!watch.active) return;
+    watch.cancel.cancel();
+    join_watch();
+    board.restore(watch.before);
+}
+
+void start_watch(Board& board) {
+    stop_watch(board);
+
+    BitBoard start;
+    if (!start.from_board(board)) return;
+
+    watch.trace.reset();
+    watch.cancel.reset();
+    watch.finished = false;
+    watch.active = true;
+    watch.before = board.snapshot();
+    watch.thread = std::thread([start]() mutable {
+        watch.solved = start.count_solutions(1, &watch.solution, &watch.trace, &watch.cancel) == 1;
+        watch.finished.store(true, std::memory_order_release);
+    });
+}
+
+void poll_watch(Board& board, Options& opts) {
+    if (!watch.active) return;
+
+    bool finished = watch.finished.load(std::memory_order_acquire);
+
+    TraceEvent event;
+    for (int k = 0; k < opts.watch_rate && watch.trace.pop(event); k++) {
+        if (!board.is_original(event.cell / 9, event.cell % 9))
+            board.set_tile(event.value, event.cell / 9, event.cell % 9);
+    }
+
+    if (!finished || !watch.trace.empty()) return;
+
+    // Eventos que ficaram no rascunho da fila nunca chegam; o estado final
+    // vem direto do resultado.
+    join_watch();
+    board.restore(watch.before);
+    if (watch.solved) {
+        for (int i = 0; i < 81; i++)
+            board.set_tile(watch.solution[i], i / 9, i % 9);
     }
 }
 
+#else
+
+void stop_watch(Board&) {}
+
+void start_watch(Board& board) {
+    board.fill(false);
+}
+
+void poll_watch(Board&, Options&) {}
+
+#endif
+
+// Com -g, só servem tabuleiros cuja técnica mais difícil é a pedida; com -x,
+// só tabuleiros mínimos.
+bool matches_options(const Grid& grid, Options& opts) {
+    if (opts.grade >= 0 && grade(grid) != opts.grade) return false;
+    if (!opts.minimal) return true;
+
+    Board board;
+    board.set_grid(grid);
+    return board.is_minimal();
+}
+
+// Caminhos sem busca: corpus pré-gerado ou simetria de uma semente. Os dois
+// só valem para o clássico sem gaiolas: o corpus não guarda variantes e nem
+// toda simetria preserva diagonais, janelas ou regiões.
+bool pick_board(Board& board, Options& opts) {
+    if (opts.variant != VARIANT_CLASSIC || opts.killer) return false;
+
+    Grid grid;
+    for (int k = 0; k < CORPUS_PICKS && corpus.pick(opts.num_remove, grid); k++) {
+        if (!matches_options(grid, opts)) continue;
+        board.set_grid(grid);
+        return true;
+    }
+
+    if (opts.instant) {
+        auto seed = seeds.find(opts.num_remove);
+        if (seed != seeds.end()) {
+            board.set_grid(random_transform(seed->second));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Com -g, o nível pode nunca produzir a técnica pedida; o pedido de novo
+// jogo desiste depois de GRADE_TRIES tabuleiros e mantém o atual.
+void warn_no_match() {
+    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_WARNING, "Atenção",
+                             "Nenhum tabuleiro desse nível usa a técnica pedida.", NULL);
+}
+
+// No killer, as gaiolas saem de uma solução aleatória; as pistas são as
+// células que o gerador precisou revelar e, para o nível valer, mais células
+// da solução até restarem no máximo `num_remove` em branco. Uma solução cujo
+// teste estoura KILLER_NODES é trocada por outra até o prazo ou o
+// cancelamento; aí tabuleiro e gaiolas ficam como estavam.
+bool make_killer(Board& board, Killer& cages, int num_remove, Clock::time_point deadline,
+                 const CancelToken* cancel) {
+    while (Clock::now() < deadline && !(cancel && cancel->cancelled())) {
+        Board full;
+        if (!full.fill(true, GENERATE_NODES, deadline, cancel)) continue;
+
+        Grid solution = full.get_grid(), givens;
+        Killer made;
+        if (!made.generate(solution, givens, deadline, cancel)) continue;
+
+        int blanks = 0;
+        for (uint8_t val : givens) blanks += val == 0;
+        while (blanks > num_remove) {
+            int i = rand() % 81;
+            if (givens[i] != 0) continue;
+            givens[i] = solution[i];
+            blanks--;
+        }
+
+        board.set_grid(givens);
+        cages = made;
+        return true;
+    }
+    return false;
+}
+
+#ifndef SUDOKU_NO_THREADS
+
+// Tenta até conseguir; com orçamento (-b), cada tentativa tem seu prazo e a
+// seguinte recomeça do zero. Devolve false se for cancelada ou, com
+// `no_match`, depois de GRADE_TRIES tabuleiros sem a técnica pedida.
+bool reset_board(Board& board, Killer& cages, Options& opts, const CancelToken* cancel, const Progress& progress,
+                 bool& no_match) {
+    cages.clear();
+    if (pick_board(board, opts)) return true;
+
+    int tries = 0;
+    while (!(cancel && cancel->cancelled())) {
+        Clock::time_point deadline = Clock::time_point::max();
+        if (opts.budget_ms > 0) deadline = Clock::now() + std::chrono::milliseconds(opts.budget_ms);
+
+        if (opts.killer) {
+            if (make_killer(board, cages, opts.num_remove, deadline, cancel)) return true;
+            continue;
+        }
+
+        if (!board.generate(opts.num_remove, deadline, cancel, progress)) continue;
+        if (opts.minimal && !board.make_minimal(cancel)) continue;
+        if (matches_options(board.get_grid(), opts)) {
+            if (opts.instant) seeds[opts.num_remove] = board.get_grid();
+            return true;
+        }
+        if (++tries == GRADE_TRIES) {
+            no_match = true;
+            return false;
+        }
+    }
+    return false;
+}
+
+// Geração em segundo plano, para a janela continuar respondendo. Só existe
+// uma de cada vez: um novo pedido cancela a anterior, que já não interessa.
+struct Generation {
+    std::thread thread;
+    CancelToken cancel;
+    std::atomic<int> progress{0};
+    std::atomic<bool> finished{false};
+    bool ok = false;
+    bool no_match = false;
+    Board board;
+    Killer cages;
+};
+
+static Generation generation;
+
+void cancel_reset() {
+    if (!generation.thread.joinable()) return;
+    generation.cancel.cancel();
+    generation.thread.join();
+}
+
+void request_reset(Board& board, State& stat, Options& opts) {
+    stop_watch(board);
+    cancel_reset();
+
+    generation.cancel.reset();
+    generation.progress = 0;
+    generation.finished = false;
+    generation.no_match = false;
+    generation.thread = std::thread([opts]() mutable {
+        generation.ok = reset_board(generation.board, generation.cages, opts, &generation.cancel, [](int done, int total) {
+            generation.progress = done * 100 / total;
+        }, generation.no_match);
+        generation.finished.store(true, std::memory_order_release);
+    });
+
+    stat.pending_reset = true;
+    stat.progress = 0;
+}
+
+// Chamada a cada quadro: adota o tabuleiro gerado quando fica pronto.
+void poll_reset(Board& board, State& stat, Options&) {
+    if (!stat.pending_reset) return;
+
+    if (!generation.finished.load(std::memory_order_acquire)) {
+        stat.progress = generation.progress;
+        return;
+    }
+
+    generation.thread.join();
+    if (!generation.ok) {
+        stat.pending_reset = false;
+        if (generation.no_match) warn_no_match();
+        return;
+    }
+
+    board.restore(generation.board.snapshot());
+    killer = generation.cages;
+    stat.pending_reset = false;
+}
+
+#else
+
+// Sem threads, a geração avança FRAME_SLICE_MS por quadro dentro do próprio
+// laço principal, então os eventos continuam sendo tratados. Um novo pedido
+// simplesmente recomeça a máquina de estados.
+static SteppedGenerator generation;
+// Tabuleiros gerados sem a técnica pedida desde o último pedido.
+static int grade_misses = 0;
+// Prazo da tentativa atual; com orçamento (-b), passado o prazo a geração
+// recomeça do zero, como na versão com threads.
+static Clock::time_point attempt_deadline;
+
+static Clock::time_point budget_deadline(Options& opts) {
+    if (opts.budget_ms <= 0) return Clock::time_point::max();
+    return Clock::now() + std::chrono::milliseconds(opts.budget_ms);
+}
+
+static void start_attempt(Options& opts) {
+    generation.start(opts.num_remove);
+    attempt_deadline = budget_deadline(opts);
+}
+
+void cancel_reset() {}
+
+void request_reset(Board& board, State& stat, Options& opts) {
+    stop_watch(board);
+    stat.progress = 0;
+    grade_misses = 0;
+    killer.clear();
+
+    stat.pending_reset = opts.killer || !pick_board(board, opts);
+    if (stat.pending_reset && !opts.killer) start_attempt(opts);
+}
+
+void poll_reset(Board& board, State& stat, Options& opts) {
+    if (!stat.pending_reset) return;
+
+    // O killer não é retomável: cada quadro tenta uma solução nova com prazo
+    // de uma fatia (ou do orçamento, se menor), e quase sempre a primeira basta.
+    if (opts.killer) {
+        Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(FRAME_SLICE_MS);
+        deadline = std::min(deadline, budget_deadline(opts));
+        stat.pending_reset = !make_killer(board, killer, opts.num_remove, deadline, nullptr);
+        return;
+    }
+
+    Clock::duration slice = std::chrono::milliseconds(FRAME_SLICE_MS);
+    if (!generation.run_for(std::min(slice, attempt_deadline - Clock::now()))) {
+        stat.progress = generation.progress();
+        if (Clock::now() >= attempt_deadline) start_attempt(opts);
+        return;
+    }
+
+    if (opts.minimal) generation.result().make_minimal();
+    if (!matches_options(generation.result().get_grid(), opts)) {
+        if (++grade_misses == GRADE_TRIES) {
+            stat.pending_reset = false;
+            warn_no_match();
+            return;
+        }
+        start_attempt(opts);
+        return;
+    }
+
+    board.restore(generation.result().snapshot());
+    if (opts.instant) seeds[opts.num_remove] = board.get_grid();
+    stat.pending_reset = false;
+}
+
+#endif
+
+// Regras do tabuleiro e, no killer, das gaiolas.
+bool is_allowed(Board& board, int val, int l, int c) {
+    if (!board.is_allowed(val, l, c)) return false;
+
+    Grid grid = board.get_grid();
+    grid[l * 9 + c] = 0;
+    return killer.allows(grid.data(), l * 9 + c, val);
+}
+
+// O solucionador do tabuleiro não conhece as gaiolas; no killer a solução
+// vem da busca com elas.
+void solve(Board& board, Options& opts) {
+    if (killer.empty()) {
+        if (opts.watch_rate > 0) start_watch(board);
+        else board.fill(false);
+        return;
+    }
+
+    Grid solution;
+    if (killer.count_solutions(board.get_grid(), 1, &solution) == 0) return;
+    for (int i = 0; i < 81; i++)
+        board.set_tile(solution[i], i / 9, i % 9);
+}
+
+// Tecla 'c': no killer, a busca com as gaiolas; senão, o portfólio de
+// estratégias num pool criado no primeiro uso, ou sem threads a busca do
+// bitboard.
+int count_board_solutions(Board& board) {
+    if (!killer.empty()) return killer.count_solutions(board.get_grid(), 2);
+
+#ifndef SUDOKU_NO_THREADS
+    static ThreadPool pool;
+    return solve_portfolio(board.get_grid(), pool).solutions;
+#else
+    BitBoard bits;
+    return bits.from_board(board) ? bits.count_solutions(2) : 0;
+#endif
+}
+
 void handle_event(SDL_Event& event, Board& board, State& stat, Options& opts) {
     if (event.type == SDL_QUIT) stat.quit = true;
     if (event.type == SDL_KEYDOWN) {
@@ -228,15 +688,22 @@ void handle_event(SDL_Event& event, Board& board, State& stat, Options& opts) {
             case SDLK_4: case SDLK_5: case SDLK_6:
             case SDLK_7: case SDLK_8: case SDLK_9: {
                 int val = event.key.keysym.sym - '0';
-                if (stat.selected && board.is_allowed(val, stat.y, stat.x)) {
+                if (stat.selected && is_allowed(board, val, stat.y, stat.x)) {
                     board.set_tile(val, stat.y, stat.x);
                 }
                 break;
             }
             case SDLK_w:
-                board.save(opts);
+                if (!killer.empty())
+                    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_WARNING, "Atenção", "Jogos killer não são salvos.", NULL);
+                else
+                    board.save(opts);
                 break;
             case SDLK_l:
+                stop_watch(board);
+                cancel_reset();
+                stat.pending_reset = false;
+                killer.clear();
                 board.load(opts);
                 break;
             case SDLK_DELETE:
@@ -251,24 +718,27 @@ void handle_event(SDL_Event& event, Board& board, State& stat, Options& opts) {
             case SDLK_RIGHTBRACKET:
                 opts.num_remove--;
                 if (opts.num_remove == 0) opts.num_remove = 1;
-                reset_board(board, opts);
+                request_reset(board, stat, opts);
                 break;
             case SDLK_LEFTBRACKET:
                 opts.num_remove++;
                 if (opts.num_remove == 59) opts.num_remove = 58;
-                reset_board(board, opts);
+                request_reset(board, stat, opts);
                 break;
             case SDLK_e:
                 board.clear();
                 break;
-            case SDLK_c:
+            case SDLK_c: {
                 board.consolidate();
+                if (count_board_solutions(board) != 1)
+                    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_WARNING, "Atenção", "O tabuleiro não tem solução única.", NULL);
                 break;
+            }
             case SDLK_n:
-                reset_board(board, opts);
+                request_reset(board, stat, opts);
                 break;
             case SDLK_s:
-                board.fill(false);
+                solve(board, opts);
                 break;
             case SDLK_h:
                 opts.hints = !opts.hints;
@@ -280,13 +750,13 @@ void handle_event(SDL_Event& event, Board& board, State& stat, Options& opts) {
                 if (stat.selected && stat.y > 0) stat.y--;
                 break;
             case SDLK_DOWN:
-                if (stat.selected && stat.y < 8) stat.y++;
+                if (stat.selected && stat.y < BOARD_SIDE - 1) stat.y++;
                 break;
             case SDLK_LEFT:
                 if (stat.selected && stat.x > 0) stat.x--;
                 break;
             case SDLK_RIGHT:
-                if (stat.selected && stat.x < 8) stat.x++;
+                if (stat.selected && stat.x < BOARD_SIDE - 1) stat.x++;
                 break;
             case SDLK_SPACE:
                 if(stat.selected && !board.is_original(stat.y, stat.x)) board.set_tile(0, stat.y, stat.x);
@@ -313,7 +783,7 @@ void handle_event(SDL_Event& event, Board& board, State& stat, Options& opts) {
                 }
             } else {
                 int grid_x = grid_coords_x(mouse_x);
-                if (stat.selected && grid_x != -1 && board.is_allowed(grid_x + 1, stat.y, stat.x))
+                if (stat.selected && grid_x != -1 && is_allowed(board, grid_x + 1, stat.y, stat.x))
                     board.set_tile(grid_x + 1, stat.y, stat.x);
             }
         } else {
@@ -326,10 +796,10 @@ void handle_event(SDL_Event& event, Board& board, State& stat, Options& opts) {
     }
 }
 
-void verify_game_over(Board& board, Options& opts) {
-    if (board.next_empty().first == -1) {
+void verify_game_over(Board& board, State& stat, Options& opts) {
+    if (!stat.pending_reset && board.next_empty().first == -1) {
         SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_INFORMATION, "Parabéns!", "Tabuleiro completo!", NULL);
-        reset_board(board, opts);
+        request_reset(board, stat, opts);
     }
 }
 
@@ -341,19 +811,26 @@ void main_game(Graphics& gpx, Options& opts) {
     else
         srand(time(NULL));
 
-    Board board;
-    reset_board(board, opts);
+    set_variant(opts.variant);
+    corpus.open(opts.corpus);
 
+    Board board;
     State stat;
+    request_reset(board, stat, opts);
 
     while(!stat.quit) {
         while(SDL_PollEvent(&event)) {
             handle_event(event, board, stat, opts);
         }
+        poll_reset(board, stat, opts);
+        poll_watch(board, opts);
         draw(gpx, stat,board, opts);
         SDL_Delay(100);
-        verify_game_over(board, opts);
+        verify_game_over(board, stat, opts);
     }
+
+    stop_watch(board);
+    cancel_reset();
 }
 
 void print_help() {
@@ -362,6 +839,16 @@ void print_help() {
     printf("\t-s: Semente do gerador de números pseudo-aleatórios.\n");
     printf("\t-a: Ativa as dicas.\n");
     printf("\t-r: Número de células em branco.\n");
+    printf("\t-c: Arquivo de tabuleiros pré-gerados.\n");
+    printf("\t-b: Tempo máximo em ms de cada tentativa de gerar um jogo.\n");
+    printf("\t-v: Mostra a busca ao solucionar (s), com tantos passos por quadro.\n");
+    printf("\t-g: Técnica mais difícil exigida (0: únicos, 1: pares apontados, 2: linha-caixa,\n");
+    printf("\t    3: subconjuntos, 4: peixes, 5: asas, 6: cadeias X, 7: cadeias alternadas,\n");
+    printf("\t    8: tentativa).\n");
+    printf("\t-x: Só tabuleiros mínimos (nenhuma pista pode sair sem perder a unicidade).\n");
+    printf("\t-i: Novos jogos instantâneos a partir de tabuleiros já gerados.\n");
+    printf("\t-t: Variante (0: clássico, 1: diagonal, 2: windoku, 3: jigsaw).\n");
+    printf("\t-k: Killer: gaiolas com a soma das células; -r, [ e ] limitam as células em branco.\n");
     printf("\n\nTeclas de atalho:\n");
     printf("\ts: Soluciona o tabuleiro.\n");
     printf("\tr: Apaga todos os números do usuário.\n");
@@ -374,11 +861,35 @@ Options parse_options(int argc, char** argv) {
     Options opts;
 
     int c;
-    while ((c = getopt(argc, argv, "s:h")) != -1) {
+    while ((c = getopt(argc, argv, "s:c:b:v:g:t:xikh")) != -1) {
         switch(c) {
             case 's':
                 opts.seed = atoi(optarg);
                 break;
+            case 'c':
+                opts.corpus = optarg;
+                break;
+            case 'b':
+                opts.budget_ms = atoi(optarg);
+                break;
+            case 'v':
+                opts.watch_rate = atoi(optarg);
+                break;
+            case 'g':
+                opts.grade = atoi(optarg);
+                break;
+            case 't':
+                opts.variant = atoi(optarg);
+                break;
+            case 'x':
+                opts.minimal = true;
+                break;
+            case 'i':
+                opts.instant = true;
+                break;
+            case 'k':
+                opts.killer = true;
+                break;
             case 'h':
                 print_help();
                 exit(EXIT_SUCCESS);
@@ -395,6 +906,27 @@ Options parse_options(int argc, char** argv) {
         exit(1);
     }
 
+    if (opts.grade >= NUM_GRADES) {
+        fprintf(stderr, "Técnica inválida.\n");
+        exit(1);
+    }
+
+    if (opts.variant < 0 || opts.variant >= NUM_VARIANTS) {
+        fprintf(stderr, "Variante inválida.\n");
+        exit(1);
+    }
+
+    // As técnicas do avaliador só conhecem linhas, colunas e caixas.
+    if (opts.grade >= 0 && (opts.variant != VARIANT_CLASSIC || opts.killer)) {
+        fprintf(stderr, "A técnica só pode ser escolhida no clássico.\n");
+        exit(1);
+    }
+
+    if (opts.minimal && opts.killer) {
+        fprintf(stderr, "O killer não tem jogos mínimos.\n");
+        exit(1);
+    }
+
     return opts;
 }
 
@@ -1,6 +1,10 @@
 #ifndef SUDOKU_SUDOKU_H
 #define SUDOKU_SUDOKU_H
 
+#include <array>
+#include <cstdint>
+#include <string>
+
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
@@ -9,6 +13,14 @@ struct Options {
     bool hints = false;
     int seed = 0;
     bool annotations = false;
+    bool instant = false;
+    int budget_ms = 0;
+    int watch_rate = 0;
+    int grade = -1;
+    bool minimal = false;
+    int variant = 0;
+    bool killer = false;
+    std::string corpus = "/usr/local/games/sudokudata/puzzles.bin";
 };
 
 struct Graphics {
@@ -20,12 +32,22 @@ struct Graphics {
 
 typedef std::pair<int, int> Coords;
 
+// Tabuleiro 9x9 em ordem de linhas, 0 = célula vazia.
+typedef std::array<uint8_t, 81> Grid;
+
+// Geometria da janela, a partir do lado das caixas do tabuleiro do jogo: entre
+// células da mesma caixa vai THIN_PAD, entre caixas e nas bordas, THICK_PAD.
+#define BOARD_BOX 3
+#define BOARD_SIDE (BOARD_BOX * BOARD_BOX)
 #define CELL_WIDTH 48
 #define THIN_PAD 8
 #define THICK_PAD 18
+#define CAGE_INSET 3
 #define WIN_TITLE "Sudoku"
-#define WIN_WIDTH (CELL_WIDTH * 9 + THIN_PAD * 6 + THICK_PAD * 4)
+#define WIN_WIDTH (CELL_WIDTH * BOARD_SIDE + THIN_PAD * (BOARD_SIDE - BOARD_BOX) + THICK_PAD * (BOARD_BOX + 1))
 #define WIN_HEIGHT (WIN_WIDTH + CELL_WIDTH + THICK_PAD - THIN_PAD)
+#define FRAME_SLICE_MS 20
+#define CORPUS_PICKS 64
 
 struct State {
     bool quit = false;
@@ -33,6 +55,8 @@ struct State {
     int x;
     int y;
     int highlight = 0;
+    bool pending_reset = false;
+    int progress = 0;
 };
 
 #endif //SUDOKU_SUDOKU_H
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+
+#include "Board.h"
+#include "Corpus.h"
+#include "Grader.h"
+
+struct CorpusOptions {
+    std::string output = "puzzles.bin";
+    int count = 100;
+    int min_level = 1;
+    int max_level = 58;
+    int seed = 0;
+    int grade = -1;
+    bool minimal = false;
+};
+
+void print_help() {
+    printf("sudoku-corpus [opções]\n");
+    printf("Gera um arquivo de tabuleiros pré-gerados, indexado por nível.\n");
+    printf("Opções:\n");
+    printf("\t-o: Arquivo de saída (padrão: puzzles.bin).\n");
+    printf("\t-n: Tabuleiros por nível (padrão: 100).\n");
+    printf("\t-m: Nível mínimo (células em branco, padrão: 1).\n");
+    printf("\t-M: Nível máximo (células em branco, padrão: 58).\n");
+    printf("\t-g: Só tabuleiros com essa técnica mais difícil (0: únicos, 1: pares apontados,\n");
+    printf("\t    2: linha-caixa, 3: subconjuntos, 4: peixes, 5: asas, 6: cadeias X,\n");
+    printf("\t    7: cadeias alternadas, 8: tentativa).\n");
+    printf("\t-x: Só tabuleiros mínimos; o nível passa a ser o mínimo de células em branco.\n");
+    printf("\t-s: Semente do gerador de números pseudo-aleatórios.\n");
+}
+
+CorpusOptions parse_options(int argc, char** argv) {
+    CorpusOptions opts;
+
+    int c;
+    while ((c = getopt(argc, argv, "o:n:m:M:s:g:xh")) != -1) {
+        switch (c) {
+            case 'o':
+                opts.output = optarg;
+                break;
+            case 'n':
+                opts.count = atoi(optarg);
+                break;
+            case 'm':
+                opts.min_level = atoi(optarg);
+                break;
+            case 'M':
+                opts.max_level = atoi(optarg);
+                break;
+            case 's':
+                opts.seed = atoi(optarg);
+                break;
+            case 'g':
+                opts.grade = atoi(optarg);
+                break;
+            case 'x':
+                opts.minimal = true;
+                break;
+            case 'h':
+                print_help();
+                exit(EXIT_SUCCESS);
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (opts.count <= 0) {
+        fprintf(stderr, "Número de tabuleiros inválido.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (opts.min_level < 1 || opts.max_level > 58 || opts.min_level > opts.max_level) {
+        fprintf(stderr, "Intervalo de níveis inválido.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (opts.grade >= NUM_GRADES) {
+        fprintf(stderr, "Técnica inválida.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return opts;
+}
+
+int main(int argc, char** argv) {
+    CorpusOptions opts = parse_options(argc, argv);
+
+    if (opts.seed != 0)
+        srand(opts.seed);
+    else
+        srand(time(NULL));
+
+    std::vector<std::vector<CorpusEntry>> levels(opts.max_level + 1);
+    Board board;
+
+    for (int level = opts.min_level; level <= opts.max_level; level++) {
+        levels[level].reserve(opts.count);
+        int misses = 0;
+        while ((int) levels[level].size() < opts.count && misses < GRADE_TRIES) {
+            misses++;
+            board.clear();
+            board.fill(true);
+            if (!board.remove(level)) continue;
+            if (opts.minimal) board.make_minimal();
+
+            Grid grid = board.get_grid();
+            if (opts.grade >= 0 && grade(grid) != opts.grade) continue;
+
+            // O esforço sai das buscas que a remoção já fez, sem outra passada.
+            uint16_t effort = std::min(board.difficulty(), 0xFFFF);
+            levels[level].push_back({grid, effort});
+            misses = 0;
+        }
+
+        // Sem o nível no arquivo, o jogo volta a gerar tabuleiros nesse nível.
+        if (misses == GRADE_TRIES) {
+            fprintf(stderr, "Nível %d: %d tentativas seguidas sem tabuleiro, nível pulado.\n", level, GRADE_TRIES);
+            levels[level].clear();
+            continue;
+        }
+
+        long total = 0;
+        for (auto& entry : levels[level]) total += entry.effort;
+        fprintf(stderr, "Nível %d: %d tabuleiros, esforço médio %.1f\n",
+                level, opts.count, (double) total / opts.count);
+    }
+
+    if (!Corpus::write(opts.output, levels)) {
+        fprintf(stderr, "Impossível escrever %s.\n", opts.output.c_str());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
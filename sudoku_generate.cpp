@@ -0,0 +1,157 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include <getopt.h>
+
+#include "Board.h"
+
+// Preenchimentos tentados para cada jogo antes de desistir; perto do limite
+// de pistas dos tabuleiros grandes, poucos chegam lá.
+#define GENERATE_ATTEMPTS 10
+
+struct GenerateOptions {
+    int box = 3;
+    int count = 1;
+    // Negativo: metade das células, arredondada para baixo.
+    int num_remove = -1;
+    int seed = 0;
+    int budget_ms = 0;
+    bool draw = false;
+};
+
+// '1'..'9' e depois 'A'..'P' para os valores 10..25; '.' para vazias.
+static char symbol(int val) {
+    if (val == 0) return '.';
+    return val <= 9 ? '0' + val : 'A' + val - 10;
+}
+
+template<int N>
+void write_board(BasicBoard<N>& board, bool draw) {
+    constexpr int SIDE = BasicBoard<N>::SIDE;
+
+    if (!draw) {
+        std::string line;
+        for (int l = 0; l < SIDE; l++)
+            for (int c = 0; c < SIDE; c++)
+                line += symbol(board.get_tile(l, c));
+        printf("%s\n", line.c_str());
+        return;
+    }
+
+    for (int l = 0; l < SIDE; l++) {
+        if (l > 0 && l % N == 0) printf("\n");
+        for (int c = 0; c < SIDE; c++) {
+            if (c > 0 && c % N == 0) printf(" ");
+            printf("%c", symbol(board.get_tile(l, c)));
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
+
+template<int N>
+int generate(GenerateOptions& opts) {
+    int num_remove = opts.num_remove >= 0 ? opts.num_remove : BasicBoard<N>::CELLS / 2;
+    if (num_remove >= BasicBoard<N>::CELLS) {
+        fprintf(stderr, "Número de células em branco inválido.\n");
+        return EXIT_FAILURE;
+    }
+
+    for (int k = 0; k < opts.count; k++) {
+        auto start = Clock::now();
+        BasicBoard<N> board;
+
+        // Cada tentativa é um preenchimento e uma remoção; com orçamento, cada
+        // uma tem seu prazo, como no jogo.
+        int attempt = 0;
+        for (; attempt < GENERATE_ATTEMPTS; attempt++) {
+            Clock::time_point deadline = Clock::time_point::max();
+            if (opts.budget_ms > 0) deadline = Clock::now() + std::chrono::milliseconds(opts.budget_ms);
+            board.clear();
+            if (board.fill(true, GENERATE_NODES, deadline) && board.remove(num_remove, deadline)) break;
+        }
+        if (attempt == GENERATE_ATTEMPTS) {
+            fprintf(stderr, "Nenhum jogo com %d células em branco em %d tentativas.\n", num_remove,
+                    GENERATE_ATTEMPTS);
+            return EXIT_FAILURE;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        fprintf(stderr, "jogo %d: %.1f ms, dificuldade %d\n", k + 1, ms, board.difficulty());
+        write_board(board, opts.draw);
+    }
+    return EXIT_SUCCESS;
+}
+
+void print_help() {
+    printf("sudoku-generate [opções]\n");
+    printf("Gera jogos clássicos de qualquer tamanho, um por linha ('1'..'9', 'A'..'P', '.').\n");
+    printf("Opções:\n");
+    printf("\t-z: Lado das caixas: 2 (4x4), 3 (9x9), 4 (16x16) ou 5 (25x25) (padrão: 3).\n");
+    printf("\t-n: Número de jogos (padrão: 1).\n");
+    printf("\t-r: Número de células em branco (padrão: metade do tabuleiro); sem jogo em\n");
+    printf("\t    %d tentativas, o programa desiste com erro.\n", GENERATE_ATTEMPTS);
+    printf("\t-s: Semente do gerador de números pseudo-aleatórios.\n");
+    printf("\t-b: Tempo máximo em ms de cada tentativa de gerar um jogo.\n");
+    printf("\t-d: Desenha o tabuleiro em vez de uma linha por jogo.\n");
+}
+
+GenerateOptions parse_options(int argc, char** argv) {
+    GenerateOptions opts;
+
+    int c;
+    while ((c = getopt(argc, argv, "z:n:r:s:b:dh")) != -1) {
+        switch (c) {
+            case 'z':
+                opts.box = atoi(optarg);
+                break;
+            case 'n':
+                opts.count = atoi(optarg);
+                break;
+            case 'r':
+                opts.num_remove = atoi(optarg);
+                break;
+            case 's':
+                opts.seed = atoi(optarg);
+                break;
+            case 'b':
+                opts.budget_ms = atoi(optarg);
+                break;
+            case 'd':
+                opts.draw = true;
+                break;
+            case 'h':
+                print_help();
+                exit(EXIT_SUCCESS);
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (optind < argc) {
+        fprintf(stderr, "Esse programa não aceita argumentos extras.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (opts.box < 2 || opts.box > 5) {
+        fprintf(stderr, "Tamanho de caixa inválido.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return opts;
+}
+
+int main(int argc, char** argv) {
+    GenerateOptions opts = parse_options(argc, argv);
+    srand(opts.seed != 0 ? opts.seed : time(NULL));
+
+    switch (opts.box) {
+        case 2: return generate<2>(opts);
+        case 3: return generate<3>(opts);
+        case 4: return generate<4>(opts);
+        default: return generate<5>(opts);
+    }
+}
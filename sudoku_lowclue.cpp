@@ -0,0 +1,409 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+#include <unistd.h>
+
+#include "BitBoard.h"
+#include "Board.h"
+#include "TextFormat.h"
+#include "Unavoidable.h"
+
+// Níveis da árvore de busca abertos antes de dividir o trabalho em tarefas.
+#define LOWCLUE_SPLIT_DEPTH 3
+// Dígitos apagados por vez ao procurar conjuntos inevitáveis iniciais.
+#define LOWCLUE_UA_DIGITS 4
+// Tamanho máximo dos conjuntos inevitáveis achados durante a busca que são
+// guardados.
+#define LOWCLUE_MAX_UA_CELLS 12
+
+struct LowClueOptions {
+    std::string input;
+    std::string output = "lowclue.txt";
+    int clues = 20;
+    int threads = 0;
+    int seed = 0;
+};
+
+// Nó da busca por conjuntos de pistas: as pistas escolhidas e as células
+// mortas, que ramos anteriores já cobriram e não podem mais entrar. Assim
+// cada conjunto de pistas aparece em um único ramo.
+struct Node {
+    Bits81 clues;
+    Bits81 dead;
+    int count = 0;
+};
+
+// Busca de conjuntos de até `k` pistas que atingem todos os conjuntos
+// inevitáveis da solução e têm solução única. Cada thread tem sua cópia dos
+// conjuntos, que cresce a cada segunda solução encontrada.
+class HittingSearch {
+private:
+    const Grid& solution;
+    int k;
+    std::vector<Bits81> sets;
+public:
+    std::vector<Grid> found;
+    long checks = 0;
+
+    HittingSearch(const Grid& solution, int k, const std::vector<Bits81>& sets)
+            : solution(solution), k(k), sets(sets) {}
+
+    // Conjunto ainda sem pista com menos células vivas; -1 se todos foram
+    // atingidos, -2 se algum não pode mais ser atingido ou se nem os conjuntos
+    // disjuntos cabem nas pistas que faltam.
+    int choose(const Node& node) {
+        int best = -1, best_live = 82;
+        int disjoint = 0;
+        Bits81 used;
+
+        for (int s = 0; s < (int) sets.size(); s++) {
+            if ((sets[s] & node.clues).any()) continue;
+            Bits81 live = sets[s].minus(node.dead);
+            int n = live.count();
+            if (n == 0) return -2;
+            if (n < best_live) {
+                best_live = n;
+                best = s;
+            }
+            if (!(live & used).any()) {
+                used |= live;
+                if (++disjoint > k - node.count) return -2;
+            }
+        }
+        return best;
+    }
+
+    Grid puzzle(const Node& node) const {
+        Grid grid = {};
+        for (int i = 0; i < 81; i++)
+            if (node.clues.test(i)) grid[i] = solution[i];
+        return grid;
+    }
+
+    // Procura uma solução diferente da original; as células que mudam formam
+    // um novo conjunto inevitável.
+    bool other_solution(BitBoard board, Bits81& diff) {
+        if (!board.propagate()) return false;
+        if (board.solved.count() == 81) {
+            Grid grid = board.to_grid();
+            diff = Bits81();
+            for (int i = 0; i < 81; i++)
+                if (grid[i] != solution[i]) diff |= Bits81::cell(i);
+            return diff.any();
+        }
+
+        int cell = board.branch_cell();
+        for (int d = 0; d < 9; d++) {
+            if (!board.planes[d].test(cell)) continue;
+            BitBoard next = board;
+            next.place(cell, d);
+            if (other_solution(next, diff)) return true;
+        }
+        return false;
+    }
+
+    // Uma pista em cada célula viva de `set`; as já tentadas morrem para os
+    // ramos seguintes.
+    void branch(const Node& node, const Bits81& set) {
+        if (node.count == k) return;
+
+        Node child = node;
+        child.count++;
+        for (Bits81 live = set.minus(node.dead); live.any();) {
+            int cell = live.first();
+            live = live.minus(Bits81::cell(cell));
+            child.clues = node.clues | Bits81::cell(cell);
+            search(child);
+            child.dead |= Bits81::cell(cell);
+        }
+    }
+
+    void search(const Node& node) {
+        int s = choose(node);
+        if (s == -2) return;
+        if (s >= 0) {
+            branch(node, sets[s]);
+            return;
+        }
+
+        checks++;
+        BitBoard board;
+        board.from_grid(puzzle(node));
+        Bits81 diff;
+        if (!other_solution(board, diff)) {
+            // Um ramo pode ter pegado uma pista que outra tornou desnecessária.
+            Board minimal;
+            minimal.set_grid(puzzle(node));
+            if (minimal.is_minimal()) found.push_back(puzzle(node));
+            return;
+        }
+
+        // A diferença costuma ser a união de vários conjuntos inevitáveis; o
+        // menor deles poda muito mais.
+        Bits81 set = Unavoidable::shrink(solution, diff);
+        if (set.count() <= LOWCLUE_MAX_UA_CELLS) {
+            auto pos = std::lower_bound(sets.begin(), sets.end(), set, [](const Bits81& a, const Bits81& b) {
+                return a.count() < b.count();
+            });
+            sets.insert(pos, set);
+        }
+        branch(node, set);
+    }
+
+    // Mesmo percurso de search(), mas só até `depth` níveis, guardando os nós
+    // da fronteira como tarefas.
+    void split(const Node& node, int depth, std::vector<Node>& tasks) {
+        int s = choose(node);
+        if (s == -2) return;
+        if (s == -1 || depth == 0 || node.count == k) {
+            tasks.push_back(node);
+            return;
+        }
+
+        Node child = node;
+        child.count++;
+        for (Bits81 live = sets[s].minus(node.dead); live.any();) {
+            int cell = live.first();
+            live = live.minus(Bits81::cell(cell));
+            child.clues = node.clues | Bits81::cell(cell);
+            split(child, depth - 1, tasks);
+            child.dead |= Bits81::cell(cell);
+        }
+    }
+};
+
+// O arquivo de saída também é o ponto de retomada: um cabeçalho com a solução
+// e os parâmetros, e depois, para cada tarefa concluída, os tabuleiros que
+// ela achou seguidos de "# tarefa N". Ao retomar, o que vier depois da última
+// marca (uma tarefa escrita pela metade) é descartado.
+class Checkpoint {
+private:
+    FILE* file = nullptr;
+    std::mutex mutex;
+public:
+    // Tarefas concluídas em execuções anteriores.
+    std::vector<bool> done;
+    size_t num_found = 0;
+
+    bool open(const std::string& path, const std::string& header, size_t num_tasks) {
+        done.assign(num_tasks, false);
+
+        long keep = 0;
+        FILE* old = fopen(path.c_str(), "r");
+        if (old != nullptr) {
+            char line[256];
+            bool valid = fgets(line, sizeof(line), old) && header == line;
+            if (!valid) {
+                fclose(old);
+                fprintf(stderr, "%s é de outra busca.\n", path.c_str());
+                return false;
+            }
+            keep = ftell(old);
+
+            size_t pending = 0;
+            while (fgets(line, sizeof(line), old)) {
+                size_t task;
+                if (sscanf(line, "# tarefa %zu", &task) == 1 && task < num_tasks) {
+                    done[task] = true;
+                    num_found += pending;
+                    pending = 0;
+                    keep = ftell(old);
+                } else if (line[0] != '#') {
+                    pending++;
+                }
+            }
+            fclose(old);
+
+            if (truncate(path.c_str(), keep) != 0) return false;
+            file = fopen(path.c_str(), "a");
+        } else {
+            file = fopen(path.c_str(), "w");
+            if (file != nullptr) fputs(header.c_str(), file);
+        }
+
+        if (file == nullptr) return false;
+        fflush(file);
+        return true;
+    }
+
+    void finish(size_t task, const std::vector<Grid>& puzzles) {
+        std::string block;
+        char line[LINE_CELLS + 1];
+        line[LINE_CELLS] = '\n';
+        for (auto& grid : puzzles) {
+            format_line(grid, line);
+            block.append(line, LINE_CELLS + 1);
+        }
+        block += "# tarefa " + std::to_string(task) + "\n";
+
+        std::lock_guard<std::mutex> lock(mutex);
+        fwrite(block.data(), 1, block.size(), file);
+        fflush(file);
+        num_found += puzzles.size();
+    }
+
+    void close() {
+        if (file != nullptr) fclose(file);
+        file = nullptr;
+    }
+};
+
+// Solução gravada no cabeçalho de um arquivo de saída existente, para
+// retomar sem arquivo de entrada nem semente.
+bool header_solution(const std::string& path, Grid& solution) {
+    FILE* file = fopen(path.c_str(), "r");
+    if (file == nullptr) return false;
+
+    char line[256], cells[LINE_CELLS + 1];
+    bool ok = fgets(line, sizeof(line), file) && sscanf(line, "# sudoku-lowclue %81s", cells) == 1 &&
+              parse_line(cells, LINE_CELLS, solution);
+    fclose(file);
+
+    BitBoard check;
+    return ok && check.from_grid(solution) && check.solved.count() == 81;
+}
+
+void print_help() {
+    printf("sudoku-lowclue [opções] [arquivo]\n");
+    printf("Procura todos os tabuleiros mínimos de até k pistas com solução única para uma solução.\n");
+    printf("A solução é a primeira linha do arquivo (\"-\" para a entrada padrão);\n");
+    printf("sem arquivo, a do cabeçalho da saída, se ela existir, ou senão uma nova sorteada.\n");
+    printf("Opções:\n");
+    printf("\t-k: Número máximo de pistas (padrão: 20).\n");
+    printf("\t-j: Número de threads (padrão: número de núcleos).\n");
+    printf("\t-o: Arquivo de saída e de retomada (padrão: lowclue.txt).\n");
+    printf("\t-s: Semente do gerador de números pseudo-aleatórios.\n");
+}
+
+LowClueOptions parse_options(int argc, char** argv) {
+    LowClueOptions opts;
+
+    int c;
+    while ((c = getopt(argc, argv, "k:j:o:s:h")) != -1) {
+        switch (c) {
+            case 'k':
+                opts.clues = atoi(optarg);
+                break;
+            case 'j':
+                opts.threads = atoi(optarg);
+                break;
+            case 'o':
+                opts.output = optarg;
+                break;
+            case 's':
+                opts.seed = atoi(optarg);
+                break;
+            case 'h':
+                print_help();
+                exit(EXIT_SUCCESS);
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (optind < argc) opts.input = argv[optind++];
+    if (optind < argc) {
+        fprintf(stderr, "Esse programa aceita apenas um arquivo de entrada.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (opts.clues < 1 || opts.clues > 81) {
+        fprintf(stderr, "Número de pistas inválido.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (opts.threads <= 0) opts.threads = std::thread::hardware_concurrency();
+    if (opts.threads <= 0) opts.threads = 1;
+
+    return opts;
+}
+
+int main(int argc, char** argv) {
+    LowClueOptions opts = parse_options(argc, argv);
+
+    Grid solution;
+    if (opts.input.empty() && opts.seed == 0 && access(opts.output.c_str(), F_OK) == 0) {
+        if (!header_solution(opts.output, solution)) {
+            fprintf(stderr, "%s não tem o cabeçalho de uma busca.\n", opts.output.c_str());
+            return EXIT_FAILURE;
+        }
+        fprintf(stderr, "Retomando a busca de %s.\n", opts.output.c_str());
+    } else if (opts.input.empty()) {
+        srand(opts.seed != 0 ? opts.seed : time(NULL));
+        Board board;
+        board.fill(true);
+        solution = board.get_grid();
+    } else {
+        PuzzleReader reader;
+        if (!reader.open(opts.input) || !reader.next(solution)) {
+            fprintf(stderr, "Impossível ler uma solução de %s.\n", opts.input.c_str());
+            return EXIT_FAILURE;
+        }
+        BitBoard check;
+        if (!check.from_grid(solution) || check.solved.count() != 81) {
+            fprintf(stderr, "A primeira linha de %s não é uma solução completa.\n", opts.input.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    char line[LINE_CELLS + 1] = {};
+    format_line(solution, line);
+    fprintf(stderr, "Solução: %s\n", line);
+
+    Unavoidable ua;
+    ua.build(solution, LOWCLUE_UA_DIGITS);
+
+    HittingSearch root(solution, opts.clues, ua.masks());
+    std::vector<Node> tasks;
+    root.split(Node(), LOWCLUE_SPLIT_DEPTH, tasks);
+
+    std::string header = "# sudoku-lowclue " + std::string(line) + " " + std::to_string(opts.clues) +
+                         " " + std::to_string(tasks.size()) + "\n";
+    Checkpoint checkpoint;
+    if (!checkpoint.open(opts.output, header, tasks.size())) {
+        fprintf(stderr, "Impossível usar %s.\n", opts.output.c_str());
+        return EXIT_FAILURE;
+    }
+
+    size_t already = 0;
+    for (bool done : checkpoint.done) already += done;
+    fprintf(stderr, "%zu conjuntos inevitáveis, %zu tarefas (%zu já concluídas)\n",
+            ua.size(), tasks.size(), already);
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> finished{already};
+    std::atomic<long> checks{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < opts.threads; t++) {
+        workers.emplace_back([&] {
+            // Os conjuntos achados numa tarefa valem para as seguintes.
+            HittingSearch search(solution, opts.clues, ua.masks());
+            for (size_t i = next++; i < tasks.size(); i = next++) {
+                if (checkpoint.done[i]) continue;
+
+                search.found.clear();
+                search.search(tasks[i]);
+                checkpoint.finish(i, search.found);
+
+                size_t n = ++finished;
+                fprintf(stderr, "\rTarefas: %zu/%zu", n, tasks.size());
+            }
+            checks += search.checks;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    checkpoint.close();
+
+    fprintf(stderr, "\n%zu tabuleiros mínimos com até %d pistas, %ld verificações de unicidade\n",
+            checkpoint.num_found, opts.clues, checks.load());
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include <getopt.h>
+
+#include "Samurai.h"
+
+// Preenchimentos tentados para cada jogo antes de desistir; perto de
+// SAMURAI_MAX_REMOVE, poucos chegam lá.
+#define SAMURAI_ATTEMPTS 100
+
+struct SamuraiOptions {
+    std::string input;
+    int count = 1;
+    int num_remove = SAMURAI_REMOVE;
+    int seed = 0;
+    int budget_ms = 0;
+    bool draw = false;
+};
+
+void write_samurai(const SamuraiGrid& grid, bool draw, const char* suffix = nullptr) {
+    if (draw) {
+        print_samurai(stdout, grid);
+        printf("%s\n", suffix ? suffix + 1 : "");
+        return;
+    }
+
+    char line[SAMURAI_LINE_CELLS + 1] = {};
+    format_samurai(grid, line);
+    printf("%s%s\n", line, suffix ? suffix : "");
+}
+
+// Um samurai por linha; linhas vazias e comentários ('#') são pulados.
+int solve_file(SamuraiOptions& opts) {
+    FILE* in = opts.input == "-" ? stdin : fopen(opts.input.c_str(), "r");
+    if (in == nullptr) {
+        fprintf(stderr, "Impossível abrir %s.\n", opts.input.c_str());
+        return EXIT_FAILURE;
+    }
+
+    size_t counts[3] = {}, invalid = 0;
+    char* line = nullptr;
+    size_t cap = 0;
+    ssize_t len;
+    while ((len = getline(&line, &cap, in)) != -1) {
+        if (len == 0 || line[0] == '\n' || line[0] == '#') continue;
+
+        SamuraiGrid grid;
+        SamuraiBitBoard board;
+        if (!parse_samurai(line, len, grid)) {
+            invalid++;
+            continue;
+        }
+
+        SamuraiGrid solution;
+        int sols = board.from_grid(grid) ? board.count_solutions(2, &solution) : 0;
+        counts[sols]++;
+        if (sols == 1) write_samurai(solution, opts.draw);
+        else write_samurai(grid, opts.draw, sols == 0 ? " unsolvable" : " multiple");
+    }
+    free(line);
+    if (in != stdin) fclose(in);
+
+    fprintf(stderr, "únicos: %zu, múltiplas soluções: %zu, sem solução: %zu, linhas inválidas: %zu\n",
+            counts[1], counts[2], counts[0], invalid);
+    return EXIT_SUCCESS;
+}
+
+int generate(SamuraiOptions& opts) {
+    srand(opts.seed != 0 ? opts.seed : time(NULL));
+
+    for (int k = 0; k < opts.count; k++) {
+        auto start = Clock::now();
+        Samurai samurai;
+
+        // Cada tentativa é um preenchimento e uma remoção; com orçamento, cada
+        // uma tem seu prazo, como no jogo.
+        int attempt = 0;
+        for (; attempt < SAMURAI_ATTEMPTS; attempt++) {
+            Clock::time_point deadline = Clock::time_point::max();
+            if (opts.budget_ms > 0) deadline = Clock::now() + std::chrono::milliseconds(opts.budget_ms);
+            samurai.clear();
+            if (samurai.fill(GENERATE_NODES, deadline) && samurai.remove(opts.num_remove, deadline)) break;
+        }
+        if (attempt == SAMURAI_ATTEMPTS) {
+            fprintf(stderr, "Nenhum jogo com %d células em branco em %d tentativas.\n", opts.num_remove,
+                    SAMURAI_ATTEMPTS);
+            return EXIT_FAILURE;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        fprintf(stderr, "jogo %d: %.1f ms, dificuldade %d\n", k + 1, ms, samurai.difficulty());
+        write_samurai(samurai.get_grid(), opts.draw);
+    }
+    return EXIT_SUCCESS;
+}
+
+void print_help() {
+    printf("sudoku-samurai [opções] [arquivo]\n");
+    printf("Sem arquivo, gera jogos samurai (cinco grades 9x9 sobrepostas nos cantos).\n");
+    printf("Com arquivo (\"-\" para a entrada padrão), resolve um samurai por linha, com as\n");
+    printf("369 células em ordem de linhas do quadro 21x21 ('.' ou '0' para vazias).\n");
+    printf("Opções:\n");
+    printf("\t-n: Número de jogos gerados (padrão: 1).\n");
+    printf("\t-r: Número de células em branco, até %d (padrão: %d).\n", SAMURAI_MAX_REMOVE, SAMURAI_REMOVE);
+    printf("\t-s: Semente do gerador de números pseudo-aleatórios.\n");
+    printf("\t-b: Tempo máximo em ms de cada tentativa de gerar um jogo.\n");
+    printf("\t-d: Desenha o quadro 21x21 em vez de uma linha por jogo.\n");
+}
+
+SamuraiOptions parse_options(int argc, char** argv) {
+    SamuraiOptions opts;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:r:s:b:dh")) != -1) {
+        switch (c) {
+            case 'n':
+                opts.count = atoi(optarg);
+                break;
+            case 'r':
+                opts.num_remove = atoi(optarg);
+                break;
+            case 's':
+                opts.seed = atoi(optarg);
+                break;
+            case 'b':
+                opts.budget_ms = atoi(optarg);
+                break;
+            case 'd':
+                opts.draw = true;
+                break;
+            case 'h':
+                print_help();
+                exit(EXIT_SUCCESS);
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (optind < argc) opts.input = argv[optind++];
+    if (optind < argc) {
+        fprintf(stderr, "Esse programa aceita apenas um arquivo de entrada.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (opts.num_remove < 1 || opts.num_remove > SAMURAI_MAX_REMOVE) {
+        fprintf(stderr, "Número de células em branco inválido.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return opts;
+}
+
+int main(int argc, char** argv) {
+    SamuraiOptions opts = parse_options(argc, argv);
+    return opts.input.empty() ? generate(opts) : solve_file(opts);
+}
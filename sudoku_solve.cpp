@@ -0,0 +1,306 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+
+#include "BitBoard.h"
+#include "Constraints.h"
+#include "ParallelSearch.h"
+#include "Portfolio.h"
+#include "TextFormat.h"
+
+#define BATCH_SIZE 256
+
+enum Status { UNIQUE, MULTIPLE, UNSOLVABLE };
+
+struct SolveOptions {
+    std::string input = "-";
+    std::string output = "-";
+    int threads = 0;
+    bool split = false;
+    bool race = false;
+    int variant = VARIANT_CLASSIC;
+};
+
+struct Batch {
+    size_t seq = 0;
+    std::vector<Grid> grids;
+    std::vector<Status> status;
+};
+
+// Fila limitada entre o leitor e os workers: o leitor bloqueia quando os
+// workers ficam para trás, então a memória não cresce com o tamanho da entrada.
+class BatchQueue {
+private:
+    std::mutex mutex;
+    std::condition_variable not_empty, not_full;
+    std::deque<Batch> batches;
+    size_t capacity;
+    bool closed = false;
+public:
+
+    explicit BatchQueue(size_t capacity) : capacity(capacity) {}
+
+    void push(Batch batch) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [&] { return batches.size() < capacity; });
+        batches.push_back(std::move(batch));
+        not_empty.notify_one();
+    }
+
+    bool pop(Batch& batch) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [&] { return !batches.empty() || closed; });
+        if (batches.empty()) return false;
+        batch = std::move(batches.front());
+        batches.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+    }
+};
+
+// Reordena os lotes prontos para a saída seguir a ordem da entrada. Um worker
+// que esteja mais de `window` lotes à frente espera o escritor alcançá-lo.
+class ReorderBuffer {
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::map<size_t, Batch> ready;
+    size_t next = 0;
+    size_t window;
+    size_t total = SIZE_MAX;
+public:
+
+    explicit ReorderBuffer(size_t window) : window(window) {}
+
+    void put(Batch batch) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return batch.seq < next + window; });
+        size_t seq = batch.seq;
+        ready.emplace(seq, std::move(batch));
+        changed.notify_all();
+    }
+
+    bool take(Batch& batch) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return ready.count(next) || next == total; });
+        if (next == total) return false;
+        batch = std::move(ready[next]);
+        ready.erase(next);
+        next++;
+        changed.notify_all();
+        return true;
+    }
+
+    void finish(size_t num_batches) {
+        std::lock_guard<std::mutex> lock(mutex);
+        total = num_batches;
+        changed.notify_all();
+    }
+};
+
+// Com `pool`, a busca de cada tabuleiro é dividida entre as threads.
+Status solve(Grid& grid, ThreadPool* pool = nullptr) {
+    BitBoard board;
+    if (!board.from_grid(grid)) return UNSOLVABLE;
+
+    Grid solution;
+    int sols = pool ? count_solutions_parallel(board, 2, *pool, &solution) : board.count_solutions(2, &solution);
+    if (sols == 0) return UNSOLVABLE;
+    if (sols > 1) return MULTIPLE;
+
+    grid = solution;
+    return UNIQUE;
+}
+
+void write_result(PuzzleWriter& output, const Grid& grid, Status status) {
+    if (status == UNIQUE) output.write(grid);
+    else output.write(grid, status == MULTIPLE ? " multiple" : " unsolvable");
+}
+
+// Muitos tabuleiros em paralelo, um lote por worker de cada vez.
+void solve_batches(PuzzleReader& reader, FILE* out, int threads, size_t counts[3]) {
+    BatchQueue queue(threads * 2);
+    ReorderBuffer reorder(threads * 4);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            Batch batch;
+            while (queue.pop(batch)) {
+                batch.status.resize(batch.grids.size());
+                for (size_t i = 0; i < batch.grids.size(); i++)
+                    batch.status[i] = solve(batch.grids[i]);
+                reorder.put(std::move(batch));
+            }
+        });
+    }
+
+    std::thread writer([&] {
+        PuzzleWriter output(out);
+        Batch batch;
+        while (reorder.take(batch)) {
+            for (size_t i = 0; i < batch.grids.size(); i++) {
+                counts[batch.status[i]]++;
+                write_result(output, batch.grids[i], batch.status[i]);
+            }
+        }
+    });
+
+    size_t seq = 0;
+    Batch batch;
+    Grid grid;
+    while (reader.next(grid)) {
+        batch.grids.push_back(grid);
+        if (batch.grids.size() == BATCH_SIZE) {
+            batch.seq = seq++;
+            queue.push(std::move(batch));
+            batch = Batch();
+            batch.grids.reserve(BATCH_SIZE);
+        }
+    }
+    if (!batch.grids.empty()) {
+        batch.seq = seq++;
+        queue.push(std::move(batch));
+    }
+
+    queue.close();
+    for (auto& worker : workers) worker.join();
+    reorder.finish(seq);
+    writer.join();
+}
+
+// Um tabuleiro por vez, disputado por várias estratégias de busca nas mesmas
+// threads do começo ao fim.
+void solve_race(PuzzleReader& reader, FILE* out, int threads, size_t counts[3]) {
+    ThreadPool pool(threads);
+    PuzzleWriter output(out);
+    Grid grid;
+    while (reader.next(grid)) {
+        PortfolioResult result = solve_portfolio(grid, pool);
+        Status status = result.solutions == 1 ? UNIQUE : result.solutions == 0 ? UNSOLVABLE : MULTIPLE;
+        counts[status]++;
+        write_result(output, status == UNIQUE ? result.solution : grid, status);
+    }
+}
+
+// Um tabuleiro por vez, cada um usando todas as threads: para poucos
+// tabuleiros muito difíceis, em vez de muitos fáceis.
+void solve_split(PuzzleReader& reader, FILE* out, int threads, size_t counts[3]) {
+    ThreadPool pool(threads);
+    PuzzleWriter output(out);
+    Grid grid;
+    while (reader.next(grid)) {
+        Status status = solve(grid, &pool);
+        counts[status]++;
+        write_result(output, grid, status);
+    }
+}
+
+void print_help() {
+    printf("sudoku-solve [opções] [arquivo]\n");
+    printf("Resolve tabuleiros no formato de 81 caracteres, um por linha.\n");
+    printf("Sem arquivo (ou com \"-\"), lê da entrada padrão.\n");
+    printf("Opções:\n");
+    printf("\t-j: Número de threads (padrão: número de núcleos).\n");
+    printf("\t-o: Arquivo de saída (padrão: saída padrão).\n");
+    printf("\t-p: Divide a busca de cada tabuleiro entre as threads.\n");
+    printf("\t-r: Resolve cada tabuleiro com várias estratégias concorrentes.\n");
+    printf("\t-t: Variante (0: clássico, 1: diagonal, 2: windoku, 3: jigsaw).\n");
+}
+
+SolveOptions parse_options(int argc, char** argv) {
+    SolveOptions opts;
+
+    int c;
+    while ((c = getopt(argc, argv, "j:o:prt:h")) != -1) {
+        switch (c) {
+            case 'j':
+                opts.threads = atoi(optarg);
+                break;
+            case 'o':
+                opts.output = optarg;
+                break;
+            case 'p':
+                opts.split = true;
+                break;
+            case 'r':
+                opts.race = true;
+                break;
+            case 't':
+                opts.variant = atoi(optarg);
+                break;
+            case 'h':
+                print_help();
+                exit(EXIT_SUCCESS);
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (optind < argc) opts.input = argv[optind++];
+    if (optind < argc) {
+        fprintf(stderr, "Esse programa aceita apenas um arquivo de entrada.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (opts.variant < 0 || opts.variant >= NUM_VARIANTS) {
+        fprintf(stderr, "Variante inválida.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (opts.threads <= 0) opts.threads = std::thread::hardware_concurrency();
+    if (opts.threads <= 0) opts.threads = 1;
+
+    return opts;
+}
+
+int main(int argc, char** argv) {
+    SolveOptions opts = parse_options(argc, argv);
+    set_variant(opts.variant);
+
+    PuzzleReader reader;
+    if (!reader.open(opts.input)) {
+        fprintf(stderr, "Impossível abrir %s.\n", opts.input.c_str());
+        return EXIT_FAILURE;
+    }
+
+    FILE* out = opts.output == "-" ? stdout : fopen(opts.output.c_str(), "w");
+    if (out == nullptr) {
+        fprintf(stderr, "Impossível abrir %s.\n", opts.output.c_str());
+        return EXIT_FAILURE;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    size_t counts[3] = {};
+    if (opts.race) solve_race(reader, out, opts.threads, counts);
+    else if (opts.split) solve_split(reader, out, opts.threads, counts);
+    else solve_batches(reader, out, opts.threads, counts);
+
+    if (out != stdout) fclose(out);
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t total = counts[UNIQUE] + counts[MULTIPLE] + counts[UNSOLVABLE];
+    fprintf(stderr, "%zu tabuleiros em %.2f s (%.0f/s), %d threads\n",
+            total, secs, secs > 0 ? total / secs : 0.0, opts.threads);
+    fprintf(stderr, "únicos: %zu, múltiplas soluções: %zu, sem solução: %zu, linhas inválidas: %zu\n",
+            counts[UNIQUE], counts[MULTIPLE], counts[UNSOLVABLE], reader.invalid_lines());
+
+    return EXIT_SUCCESS;
+}